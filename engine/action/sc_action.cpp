@@ -38,7 +38,10 @@ void do_execute( action_t* action, execute_type type )
     action->total_executions++;
     action->player->sequence_add( action, action->target, action->sim->current_time() );
   }
-  action->execute();
+  {
+    cpu_profile_t::scope_t profile( action->sim->cpu_profile, action, cpu_profile_t::PHASE_EXECUTE );
+    action->execute();
+  }
   action->line_cooldown.start();
 
   // If the ability has a GCD, we need to start it
@@ -170,6 +173,7 @@ struct action_execute_event_t : public player_event_t
       // Action target must follow any potential pre-execute-state target if it differs from the
       // current (default) target of the action.
       action->set_target( target );
+      cpu_profile_t::scope_t profile( action->sim->cpu_profile, action, cpu_profile_t::PHASE_EXECUTE );
       action->execute();
     }
     else
@@ -445,6 +449,9 @@ action_t::action_t( action_e ty, const std::string& token, player_t* p, const sp
     action_list(),
     starved_proc(),
     total_executions(),
+    callback_dispatch(),
+    callbacks_checked(),
+    callbacks_fired(),
     line_cooldown( "line_cd", *p ),
     signature(),
     execute_state(),
@@ -1578,6 +1585,7 @@ void action_t::execute()
     {
       assert( !execute_action->pre_execute_state );
       execute_action->set_target( execute_state->target );
+      cpu_profile_t::scope_t profile( sim->cpu_profile, execute_action, cpu_profile_t::PHASE_EXECUTE );
       execute_action->execute();
     }
 
@@ -1590,13 +1598,13 @@ void action_t::execute()
       // "On spell cast", only performed for foreground actions
       if ( ( pt2 = execute_state->cast_proc_type2() ) != PROC2_INVALID )
       {
-        action_callback_t::trigger( player->callbacks.procs[ pt ][ pt2 ], this, execute_state );
+        trigger_callbacks( pt, pt2, execute_state );
       }
 
       // "On an execute result"
       if ( ( pt2 = execute_state->execute_proc_type2() ) != PROC2_INVALID )
       {
-        action_callback_t::trigger( player->callbacks.procs[ pt ][ pt2 ], this, execute_state );
+        trigger_callbacks( pt, pt2, execute_state );
       }
     }
   }
@@ -2137,6 +2145,8 @@ bool action_t::select_target()
 
 bool action_t::action_ready()
 {
+  cpu_profile_t::scope_t profile( sim->cpu_profile, this, cpu_profile_t::PHASE_READY );
+
   // Check that the ability itself is usable, before going on to other user-input related readiness
   // checks. Note, no target-based stuff should be done here
   if ( !ready() )
@@ -2429,6 +2439,9 @@ void action_t::init()
 
 void action_t::init_finished()
 {
+  // Everything here is expression setup, part of the init_finished phase of the actor
+  init_profile_t::timer_t timer( sim->init_profile, player, "init_finished/expressions" );
+
   if ( !option.target_if_str.empty() )
   {
     std::string::size_type offset = option.target_if_str.find( ':' );
@@ -2514,6 +2527,41 @@ void action_t::init_finished()
   }
 }
 
+/**
+ * Resolve the player callbacks this action can trigger for each proc type and proc type2 into the
+ * action's dispatch table. The table is rebuilt in place when the player registers new callbacks.
+ */
+void action_t::init_callback_dispatch()
+{
+  if ( ! callback_dispatch )
+  {
+    callback_dispatch = std::make_unique<action_callback_dispatch_t>();
+  }
+
+  auto& dispatch = *callback_dispatch;
+  dispatch.generation = player->callbacks.generation;
+  dispatch.callbacks.clear();
+
+  for ( proc_types pt = PROC1_TYPE_MIN; pt < PROC1_TYPE_MAX; pt++ )
+  {
+    for ( proc_types2 pt2 = PROC2_TYPE_MIN; pt2 < PROC2_TYPE_MAX; pt2++ )
+    {
+      dispatch.offsets[ pt * PROC2_TYPE_MAX + pt2 ] = as<unsigned>( dispatch.callbacks.size() );
+
+      for ( auto cb : player->callbacks.procs[ pt ][ pt2 ] )
+      {
+        // Callbacks that disallow procs stay in the table, as they end the dispatch for proc actions
+        if ( cb->can_trigger( this ) || ! cb->allow_procs )
+        {
+          dispatch.callbacks.push_back( cb );
+        }
+      }
+    }
+  }
+
+  dispatch.offsets.back() = as<unsigned>( dispatch.callbacks.size() );
+}
+
 void action_t::reset()
 {
   if ( pre_execute_state )
@@ -2550,6 +2598,16 @@ void action_t::reset()
       expr_t::optimize_expression(interrupt_if_expr);
       expr_t::optimize_expression(early_chain_if_expr);
       expr_t::optimize_expression(cancel_if_expr);
+
+    // Lower the (now optimized) expressions into flat programs
+    if ( sim->compile_expressions )
+    {
+      expr_t::compile_expression( if_expr );
+      expr_t::compile_expression( target_if_expr );
+      expr_t::compile_expression( interrupt_if_expr );
+      expr_t::compile_expression( early_chain_if_expr );
+      expr_t::compile_expression( cancel_if_expr );
+    }
   }
 }
 
@@ -3664,7 +3722,10 @@ void action_t::do_schedule_travel( action_state_t* state, const timespan_t& time
 {
   if ( time_ <= timespan_t::zero() )
   {
-    impact( state );
+    {
+      cpu_profile_t::scope_t profile( sim->cpu_profile, this, cpu_profile_t::PHASE_IMPACT );
+      impact( state );
+    }
     action_state_t::release( state );
   }
   else
@@ -3711,6 +3772,7 @@ void action_t::impact( action_state_t* s )
     {
       assert( !impact_action->pre_execute_state );
       impact_action->set_target( s->target );
+      cpu_profile_t::scope_t profile( sim->cpu_profile, impact_action, cpu_profile_t::PHASE_EXECUTE );
       impact_action->execute();
     }
   }
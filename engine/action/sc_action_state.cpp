@@ -243,6 +243,7 @@ void travel_event_t::execute()
 {
   if ( !state->target->is_sleeping() )
   {
+    cpu_profile_t::scope_t profile( sim().cpu_profile, action, cpu_profile_t::PHASE_IMPACT );
     action->impact( state );
   }
 
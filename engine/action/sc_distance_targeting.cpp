@@ -38,26 +38,30 @@ bool action_t::execute_targeting( action_t* action ) const
   return true;
 }
 
-// This returns a list of all targets currently in range. 
-std::vector<player_t*> action_t::targets_in_range_list(
+// This filters the target list down to the targets currently in range.
+std::vector<player_t*>& action_t::targets_in_range_list(
     std::vector<player_t*>& tl ) const
 {
-  size_t i = tl.size();
-  while ( i > 0 )
+  bool use_index = range > 0.0 && sim->distance_targeting_enabled;
+  if ( use_index )
   {
-    i--;
-    player_t* target_ = tl[ i ];
-    if ( range > 0.0 && player->get_player_distance( *target_ ) > range )
+    sim->spatial_index.query( player->x_position, player->y_position, range );
+  }
+
+  tl.erase( std::remove_if( tl.begin(), tl.end(), [ this, use_index ]( player_t* target_ ) {
+    if ( use_index && !sim->spatial_index.candidate( target_ ) )
     {
-      tl.erase( tl.begin() + i );
+      return true;
     }
-    else if ( !ground_aoe && target_->debuffs.invulnerable && target_->debuffs.invulnerable->check() )
+    if ( range > 0.0 && player->get_player_distance( *target_ ) > range )
     {
-      // Cannot target invulnerable mobs, unless it's a ground aoe. It just
-      // won't do damage.
-      tl.erase( tl.begin() + i );
+      return true;
     }
-  }
+    // Cannot target invulnerable mobs, unless it's a ground aoe. It just
+    // won't do damage.
+    return !ground_aoe && target_->debuffs.invulnerable && target_->debuffs.invulnerable->check();
+  } ), tl.end() );
+
   return tl;
 }
 
@@ -66,69 +70,87 @@ std::vector<player_t*>& action_t::check_distance_targeting(
 {
   if ( sim -> distance_targeting_enabled )
   {
-    size_t i = tl.size();
-    while ( i > 0 )
-    {
-      i--;
-      player_t* t = tl[i];
-      if ( t != target )
-      {
+    // Find where the impact originates from, and how far from it a target may be. The
+    // origin is the same for every target, so the candidates can be looked up once.
+    bool check_distance = true;
+    bool add_combat_reach = true;
+    double origin_x = player->x_position;
+    double origin_y = player->y_position;
+    double max_distance = radius;
+    if ( radius > 0 && range > 0 )
+    {  // Abilities with range/radius radiate from the target.
+      if ( ground_aoe && parent_dot && parent_dot->is_ticking() )
+      {  // We need to check the parents dot for location.
         if ( sim->log )
-        {
-          sim->out_debug.printf(
-            "%s action %s - Range %.3f, Radius %.3f, player location "
-            "x=%.3f,y=%.3f, original target: %s - location: x=%.3f,y=%.3f, "
-            "impact target: %s - location: x=%.3f,y=%.3f",
-            player->name(), name(), range, radius, player->x_position,
-            player->y_position, target->name(), target->x_position,
-            target->y_position, t->name(), t->x_position, t->y_position );
-        }
-        if ( ( ground_aoe && t->debuffs.flying && t->debuffs.flying->check() ) )
-        {
-          tl.erase( tl.begin() + i );
-        }
-        else if ( radius > 0 && range > 0 )
-        {  // Abilities with range/radius radiate from the target.
-          if ( ground_aoe && parent_dot && parent_dot->is_ticking() )
-          {  // We need to check the parents dot for location.
-            if ( sim->log )
-              sim->out_debug.printf( "parent_dot location: x=%.3f,y%.3f",
-                                     parent_dot->state->original_x,
-                                     parent_dot->state->original_y );
-            if ( t->get_ground_aoe_distance( *parent_dot->state ) >
-                 radius + t->combat_reach )
-            {
-              tl.erase( tl.begin() + i );
-            }
-          }
-          else if ( ground_aoe && execute_state )
-          {
-            if ( t->get_ground_aoe_distance( *execute_state ) >
-                 radius + t->combat_reach )
-            {
-              tl.erase( tl.begin() + i );  // We should just check the child.
-            }
-          }
-          else if ( t->get_player_distance( *target ) > radius )
-          {
-            tl.erase( tl.begin() + i );
-          }
-        }  // If they do not have a range, they are likely based on the distance
-           // from the player.
-        else if ( radius > 0 &&
-                  t->get_player_distance( *player ) > radius + t->combat_reach )
-        {
-          tl.erase( tl.begin() + i );
-        }
-        else if ( range > 0 &&
-                  t->get_player_distance( *player ) > range + t->combat_reach )
-        {
-          // If they only have a range, then they are a single target ability, or
-          // are also based on the distance from the player.
-          tl.erase( tl.begin() + i );
-        }
+          sim->out_debug.printf( "parent_dot location: x=%.3f,y%.3f",
+                                 parent_dot->state->original_x,
+                                 parent_dot->state->original_y );
+        origin_x = parent_dot->state->original_x;
+        origin_y = parent_dot->state->original_y;
+      }
+      else if ( ground_aoe && execute_state )
+      {  // We should just check the child.
+        origin_x = execute_state->original_x;
+        origin_y = execute_state->original_y;
       }
+      else
+      {
+        origin_x = target->x_position;
+        origin_y = target->y_position;
+        add_combat_reach = false;
+      }
+    }  // If they do not have a range, they are likely based on the distance
+       // from the player.
+    else if ( radius <= 0 && range > 0 )
+    {
+      // If they only have a range, then they are a single target ability, or
+      // are also based on the distance from the player.
+      max_distance = range;
     }
+    else if ( radius <= 0 )
+    {
+      check_distance = false;
+    }
+
+    if ( check_distance )
+    {
+      sim->spatial_index.query( origin_x, origin_y,
+          max_distance + ( add_combat_reach ? sim->spatial_index.max_reach : 0.0 ) );
+    }
+
+    tl.erase( std::remove_if( tl.begin(), tl.end(), [ & ]( player_t* t ) {
+      if ( t == target )
+      {
+        return false;
+      }
+
+      if ( sim->log )
+      {
+        sim->out_debug.printf(
+          "%s action %s - Range %.3f, Radius %.3f, player location "
+          "x=%.3f,y=%.3f, original target: %s - location: x=%.3f,y=%.3f, "
+          "impact target: %s - location: x=%.3f,y=%.3f",
+          player->name(), name(), range, radius, player->x_position,
+          player->y_position, target->name(), target->x_position,
+          target->y_position, t->name(), t->x_position, t->y_position );
+      }
+
+      if ( ground_aoe && t->debuffs.flying && t->debuffs.flying->check() )
+      {
+        return true;
+      }
+
+      if ( !check_distance )
+      {
+        return false;
+      }
+
+      // Targets outside of the queried cells are out of range without further checks
+      return !sim->spatial_index.candidate( t ) ||
+             t->get_position_distance( origin_x, origin_y ) >
+                 max_distance + ( add_combat_reach ? t->combat_reach : 0.0 );
+    } ), tl.end() );
+
     if ( sim->log )
     {
       sim->out_debug.printf( "%s regenerated target cache for %s (%s)",
@@ -303,6 +325,19 @@ double player_t::get_ground_aoe_distance( const action_state_t& a ) const
   return get_position_distance( a.original_x, a.original_y );
 }
 
+// player_t::set_position ======================================================
+
+void player_t::set_position( double x, double y )
+{
+  x_position = x;
+  y_position = y;
+
+  if ( sim->distance_targeting_enabled )
+  {
+    sim->spatial_index.update( this );
+  }
+}
+
 // player_t::init_distance_targeting ===========================================
 
 void player_t::init_distance_targeting()
@@ -310,7 +345,115 @@ void player_t::init_distance_targeting()
   if ( !sim->distance_targeting_enabled )
     return;
 
-  x_position = -1 * base.distance;
+  set_position( -1 * base.distance, y_position );
+}
+
+// Spatial index ===============================================================
+
+spatial_index_t::spatial_index_t() :
+  cell_size( 10.0 ), max_reach( 0.0 ), stamp( 0 ), query_all( false )
+{ }
+
+int32_t spatial_index_t::cell_coordinate( double v ) const
+{
+  return static_cast<int32_t>( std::floor( v / cell_size ) );
+}
+
+int64_t spatial_index_t::cell_key( int32_t cx, int32_t cy )
+{
+  return static_cast<int64_t>( static_cast<uint64_t>( static_cast<uint32_t>( cx ) ) << 32 |
+                               static_cast<uint32_t>( cy ) );
+}
+
+// spatial_index_t::update =====================================================
+
+void spatial_index_t::update( player_t* actor )
+{
+  if ( actor->actor_index >= entries.size() )
+  {
+    entries.resize( actor->actor_index + 1, entry_t{ 0, 0, false } );
+  }
+
+  entry_t& entry = entries[ actor->actor_index ];
+  int64_t cell = cell_key( cell_coordinate( actor->x_position ), cell_coordinate( actor->y_position ) );
+  if ( entry.indexed )
+  {
+    if ( entry.cell == cell )
+    {
+      return;
+    }
+
+    auto& old_cell = cells[ entry.cell ];
+    auto it = range::find( old_cell, actor );
+    assert( it != old_cell.end() );
+    *it = old_cell.back();
+    old_cell.pop_back();
+  }
+
+  cells[ cell ].push_back( actor );
+  entry.cell = cell;
+  entry.indexed = true;
+  max_reach = std::max( max_reach, actor->combat_reach );
+}
+
+// spatial_index_t::query ======================================================
+
+void spatial_index_t::query( double x, double y, double radius )
+{
+  if ( ++stamp == 0 )
+  {
+    // Stamp wrapped around, forget all previous marks
+    range::for_each( entries, []( entry_t& entry ) { entry.stamp = 0; } );
+    stamp = 1;
+  }
+
+  // Distances are computed with util::approx_sqrt, which may come in slightly under the
+  // exact distance. Pad the query so that no actor in range is left out.
+  radius = radius * 1.01 + 0.01;
+
+  double cells_x = std::floor( ( x + radius ) / cell_size ) - std::floor( ( x - radius ) / cell_size ) + 1;
+  double cells_y = std::floor( ( y + radius ) / cell_size ) - std::floor( ( y - radius ) / cell_size ) + 1;
+
+  // Visiting every covered cell would cost more than looking at all actors
+  query_all = cells_x * cells_y > static_cast<double>( cells.size() );
+  if ( query_all )
+  {
+    return;
+  }
+
+  int32_t x_min = cell_coordinate( x - radius ), x_max = cell_coordinate( x + radius );
+  int32_t y_min = cell_coordinate( y - radius ), y_max = cell_coordinate( y + radius );
+  for ( int32_t cx = x_min; cx <= x_max; cx++ )
+  {
+    for ( int32_t cy = y_min; cy <= y_max; cy++ )
+    {
+      auto it = cells.find( cell_key( cx, cy ) );
+      if ( it == cells.end() )
+      {
+        continue;
+      }
+
+      for ( const player_t* actor : it->second )
+      {
+        entries[ actor->actor_index ].stamp = stamp;
+      }
+    }
+  }
+}
+
+// spatial_index_t::candidate ==================================================
+
+bool spatial_index_t::candidate( const player_t* actor ) const
+{
+  if ( query_all || actor->actor_index >= entries.size() )
+  {
+    return true;
+  }
+
+  const entry_t& entry = entries[ actor->actor_index ];
+
+  // Actors that have never been positioned are not in the grid
+  return !entry.indexed || entry.stamp == stamp;
 }
 
 // Generic helper functions ==================================================
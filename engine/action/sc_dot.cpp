@@ -1047,7 +1047,10 @@ void dot_t::tick()
         current_tick, num_ticks, last_start.total_seconds(),
         current_duration.total_seconds(), time_to_tick.total_seconds() );
 
-  current_action->tick( this );
+  {
+    cpu_profile_t::scope_t profile( sim.cpu_profile, current_action, cpu_profile_t::PHASE_TICK );
+    current_action->tick( this );
+  }
   prev_tick_time = sim.current_time();
 }
 
@@ -1129,7 +1132,10 @@ void dot_t::schedule_tick()
       current_action->player->gcd_ready =
           sim.current_time() + current_action->gcd();
       current_action->set_target( target );
-      current_action->execute();
+      {
+        cpu_profile_t::scope_t profile( sim.cpu_profile, current_action, cpu_profile_t::PHASE_EXECUTE );
+        current_action->execute();
+      }
       if ( current_action->result_is_hit(
                current_action->execute_state->result ) )
       {
@@ -27,6 +27,7 @@ stats_t::stats_t( const std::string& n, player_t* p ) :
   total_execute_time(), total_tick_time(),
   iteration_total_execute_time( timespan_t::zero() ),
   iteration_total_tick_time( timespan_t::zero() ),
+  last_iteration_amount( 0 ),
   portion_amount( 0 ),
   total_intervals(),
   last_execute( timespan_t::min() ),
@@ -45,6 +46,14 @@ stats_t::stats_t( const std::string& n, player_t* p ) :
   scaling( nullptr ),
   timeline_amount( nullptr )
 {
+  if ( sim.sample_data_sketch > 0 )
+  {
+    actual_amount.enable_sketch( sim.sample_data_sketch );
+    total_amount.enable_sketch( sim.sample_data_sketch );
+    portion_aps.enable_sketch( sim.sample_data_sketch );
+    portion_apse.enable_sketch( sim.sample_data_sketch );
+  }
+
   int size = std::min( sim.iterations, 10000 );
   actual_amount.reserve( size );
   total_amount.reserve( size );
@@ -54,6 +63,7 @@ stats_t::stats_t( const std::string& n, player_t* p ) :
   if ( sim.report_details != 0 )
   {
     timeline_amount = std::make_unique<sc_timeline_t>( );
+    timeline_amount -> attach( sim.timeline_arena );
   }
 }
 
@@ -250,6 +260,7 @@ void stats_t::datacollection_end()
 
   actual_amount.add( iaa );
   total_amount.add( ita );
+  last_iteration_amount = iaa;
 
   total_execute_time.add( iteration_total_execute_time.total_seconds() );
   total_tick_time.add( iteration_total_tick_time.total_seconds() );
@@ -15,10 +15,11 @@ struct buff_expr_t : public expr_t
   buff_t* static_buff;
   target_specific_t<buff_t> specific_buff;
   double default_value;
+  expr_epoch_cache_t cache;
 
   buff_expr_t( const std::string& n, const std::string& bn, action_t* a, buff_t* b, double default_ = 0 )
     : expr_t( n ), buff_name( bn ), action( a ), static_buff( b ), specific_buff( false ),
-      default_value( default_ )
+      default_value( default_ ), cache()
   { }
 
   virtual buff_t* create() const
@@ -56,6 +57,18 @@ struct buff_expr_t : public expr_t
     return buff;
   }
 
+  // Queries of a static buff only depend on the buff state and the current time, so their values
+  // are memoized per timestamp and buff state epoch. Dynamic (target-specific) buffs are always
+  // evaluated, as the action target may change between evaluations.
+  template <typename F>
+  double memoize( F&& f )
+  {
+    if ( !static_buff )
+      return expr_t::coerce( f() );
+
+    return cache.get( static_buff->sim->current_time(), static_buff->state_epoch, std::forward<F>( f ) );
+  }
+
   bool is_constant( double* v ) override
   {
     bool constant = buff()->s_data != spell_data_t::nil() && !buff()->s_data->ok();
@@ -295,7 +308,7 @@ std::unique_ptr<expr_t> create_buff_expression( std::string buff_name, const std
       { }
 
       double evaluate() override
-      { return buff()->remains().total_seconds(); }
+      { return memoize( [ this ] { return buff()->remains(); } ); }
     };
 
     return std::make_unique<remains_expr_t>( buff_name, action, static_buff );
@@ -322,7 +335,7 @@ std::unique_ptr<expr_t> create_buff_expression( std::string buff_name, const std
       { }
 
       double evaluate() override
-      { return buff()->check() > 0; }
+      { return memoize( [ this ] { return buff()->check() > 0; } ); }
     };
 
     return std::make_unique<up_expr_t>( buff_name, action, static_buff );
@@ -336,7 +349,7 @@ std::unique_ptr<expr_t> create_buff_expression( std::string buff_name, const std
       { }
 
       double evaluate() override
-      { return buff()->check() <= 0; }
+      { return memoize( [ this ] { return buff()->check() <= 0; } ); }
     };
 
     return std::make_unique<down_expr_t>( buff_name, action, static_buff );
@@ -349,7 +362,7 @@ std::unique_ptr<expr_t> create_buff_expression( std::string buff_name, const std
       { }
 
       double evaluate() override
-      { return buff()->check(); }
+      { return memoize( [ this ] { return buff()->check(); } ); }
     };
 
     return std::make_unique<stack_expr_t>( buff_name, action, static_buff );
@@ -413,7 +426,7 @@ std::unique_ptr<expr_t> create_buff_expression( std::string buff_name, const std
       }
 
       double evaluate() override
-      { return buff()->stack_react(); }
+      { return memoize( [ this ] { return buff()->stack_react(); } ); }
     };
 
     return std::make_unique<react_expr_t>( buff_name, action, static_buff );
@@ -535,6 +548,8 @@ buff_t::buff_t( sim_t* sim, player_t* target, player_t* source, const std::strin
     buff_duration( timespan_t::min() ),
     default_chance( 1.0 ),
     manual_chance( -1.0 ),
+    state_epoch( 0 ),
+    dirty( false ),
     current_tick( 0 ),
     buff_period( timespan_t::min() ),
     tick_time_behavior( buff_tick_time_behavior::UNHASTED ),
@@ -613,6 +628,11 @@ buff_t::buff_t( sim_t* sim, player_t* target, player_t* source, const std::strin
   set_max_stack( _max_stack );
 
   update_trigger_calculations();
+
+  if ( sim->buff_uptime_timeline )
+  {
+    uptime_array.attach( sim->timeline_arena );
+  }
 }
 
 void buff_t::update_trigger_calculations()
@@ -1230,6 +1250,8 @@ bool buff_t::trigger( int stacks, double value, double chance, timespan_t durati
       return false;
   }
 
+  mark_dirty();
+
   if ( ( !activated || stack_behavior == buff_stack_behavior::ASYNCHRONOUS ) && player && player->in_combat &&
        sim->default_aura_delay > timespan_t::zero() )
   {
@@ -1254,6 +1276,8 @@ bool buff_t::trigger( int stacks, double value, double chance, timespan_t durati
 
 void buff_t::execute( int stacks, double value, timespan_t duration )
 {
+  mark_dirty();
+
   if ( value == DEFAULT_VALUE() && default_value != DEFAULT_VALUE() )
     value = default_value;
 
@@ -1316,6 +1340,9 @@ void buff_t::increment( int stacks, double value, timespan_t duration )
 
 void buff_t::decrement( int stacks, double value )
 {
+  ++state_epoch;
+  mark_dirty();
+
   if ( overridden )
     return;
 
@@ -1363,6 +1390,9 @@ void buff_t::decrement( int stacks, double value )
 
 void buff_t::extend_duration( player_t* p, timespan_t extra_seconds )
 {
+  ++state_epoch;
+  mark_dirty();
+
   if ( !check() )
   {
     return;
@@ -1410,6 +1440,9 @@ void buff_t::extend_duration( player_t* p, timespan_t extra_seconds )
 
 void buff_t::start( int stacks, double value, timespan_t duration )
 {
+  ++state_epoch;
+  mark_dirty();
+
   if ( _max_stack == 0 )
     return;
 
@@ -1503,6 +1536,9 @@ void buff_t::start( int stacks, double value, timespan_t duration )
 
 void buff_t::refresh( int stacks, double value, timespan_t duration )
 {
+  ++state_epoch;
+  mark_dirty();
+
   if ( _max_stack == 0 )
     return;
 
@@ -1586,6 +1622,9 @@ void buff_t::refresh( int stacks, double value, timespan_t duration )
 
 void buff_t::bump( int stacks, double value )
 {
+  ++state_epoch;
+  mark_dirty();
+
   if ( _max_stack == 0 )
     return;
 
@@ -1740,12 +1779,16 @@ void buff_t::override_buff( int stacks, double value )
 
 void buff_t::expire( timespan_t delay )
 {
+  ++state_epoch;
+
   if ( current_stack <= 0 )
   {
     assert( tick_event == nullptr );
     return;
   }
 
+  mark_dirty();
+
   if ( delay > timespan_t::zero() )  // Expiration Delay
   {
     if ( !expiration_delay )  // Don't reschedule already existing expiration delay
@@ -1845,6 +1888,8 @@ void buff_t::expire( timespan_t delay )
 
 void buff_t::predict()
 {
+  ++state_epoch;
+  mark_dirty();
   // Guarantee that may_react() will return true if the buff is present.
   std::fill( stack_react_time.begin(), stack_react_time.begin() + current_stack + 1, timespan_t::min() );
 }
@@ -1886,6 +1931,8 @@ void buff_t::aura_loss()
 
 void buff_t::reset()
 {
+  ++state_epoch;
+
   event_t::cancel( delay );
   event_t::cancel( expiration_delay );
   event_t::cancel( tick_event );
@@ -1897,6 +1944,63 @@ void buff_t::reset()
   last_stack_change = timespan_t::min();
 }
 
+void buff_t::mark_dirty()
+{
+  if ( dirty || !sim->dirty_reset )
+  {
+    return;
+  }
+
+  // Dirty buffs are reset from the dirty list alone, so any list reset every iteration works. Buffs
+  // on an actor use the list of that actor.
+  dirty = true;
+  if ( player )
+    player->dirty_buffs.push_back( this );
+  else
+    sim->dirty_buffs.push_back( this );
+}
+
+bool buff_t::in_reset_state() const
+{
+  return current_stack == 0 && expiration.empty() && !delay && !expiration_delay && !tick_event &&
+         !cooldown->down() && last_start == timespan_t::min() && last_trigger == timespan_t::min() &&
+         last_expire == timespan_t::min() && last_stack_change == timespan_t::min();
+}
+
+void buff_t::reset_buffs( sim_t& sim, const std::vector<buff_t*>& buffs, std::vector<buff_t*>& dirty_buffs )
+{
+  if ( !sim.dirty_reset )
+  {
+    for ( buff_t* b : buffs )
+      b->reset();
+    return;
+  }
+
+  // Every buff left off the dirty list has to be in the state a full reset would leave it in
+  if ( sim.dirty_reset_verify )
+  {
+    for ( buff_t* b : buffs )
+    {
+      if ( !b->dirty && !b->in_reset_state() )
+      {
+        sim.error( "Buff {} changed during the iteration without being marked dirty.", *b );
+        b->mark_dirty();
+      }
+    }
+  }
+
+  // Buffs changed by the reset of other buffs are registered again for the next iteration, unless
+  // their own reset is still pending
+  thread_local std::vector<buff_t*> resetting;
+  resetting.swap( dirty_buffs );
+  for ( buff_t* b : resetting )
+  {
+    b->reset();
+    b->dirty = false;
+  }
+  resetting.clear();
+}
+
 void buff_t::merge( const buff_t& other )
 {
   start_intervals.merge( other.start_intervals );
@@ -2288,6 +2392,8 @@ void stat_buff_t::bump( int stacks, double /* value */ )
 
 void stat_buff_t::decrement( int stacks, double /* value */ )
 {
+  ++state_epoch;
+
   if ( stacks == 0 || current_stack <= stacks )
   {
     expire();
@@ -2405,6 +2511,8 @@ void cost_reduction_buff_t::bump( int stacks, double value )
 
 void cost_reduction_buff_t::decrement( int stacks, double /* value */ )
 {
+  ++state_epoch;
+
   if ( stacks == 0 || current_stack <= stacks )
   {
     expire();
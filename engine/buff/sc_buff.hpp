@@ -86,6 +86,8 @@ public:
   double manual_chance; // user-specified "overridden" proc-chance
   std::vector<timespan_t> stack_react_time;
   std::vector<event_t*> stack_react_ready_triggers;
+  uint64_t state_epoch; // Incremented on every state change, see expr_epoch_cache_t
+  bool dirty; // Registered on the dirty buff list of its owner, see mark_dirty()
 
   buff_refresh_behavior refresh_behavior;
   buff_refresh_duration_callback_t refresh_duration_callback;
@@ -240,6 +242,11 @@ public:
   virtual void expire_override( int /* expiration_stacks */, timespan_t /* remaining_duration */ ) {}
   virtual void predict();
   virtual void reset();
+  // Register the buff to be reset at the end of the iteration, when the sim uses dirty_reset
+  void mark_dirty();
+  bool in_reset_state() const;
+  // Reset the buffs of an owner, or only the ones on its dirty list when the sim uses dirty_reset
+  static void reset_buffs( sim_t& sim, const std::vector<buff_t*>& buffs, std::vector<buff_t*>& dirty_buffs );
   virtual void aura_gain();
   virtual void aura_loss();
   virtual void merge( const buff_t& other_buff );
@@ -1702,36 +1702,37 @@ double paladin_t::temporary_movement_modifier() const
   return temporary;
 }
 
-// paladin_t::invalidate_cache ==============================================
+// paladin_t::init_stat_cache ===============================================
 
-void paladin_t::invalidate_cache( cache_e c )
+void paladin_t::init_stat_cache()
 {
-  player_t::invalidate_cache( c );
+  player_t::init_stat_cache();
 
-  if ( ( specialization() == PALADIN_RETRIBUTION || specialization() == PALADIN_PROTECTION ) &&
-       ( c == CACHE_STRENGTH || c == CACHE_ATTACK_POWER ) )
+  if ( specialization() == PALADIN_RETRIBUTION || specialization() == PALADIN_PROTECTION )
   {
-    player_t::invalidate_cache( CACHE_SPELL_POWER );
+    cache.add_dependency( CACHE_STRENGTH, CACHE_SPELL_POWER );
+    cache.add_dependency( CACHE_ATTACK_POWER, CACHE_SPELL_POWER );
   }
 
-  if ( specialization() == PALADIN_HOLY && ( c == CACHE_INTELLECT || c == CACHE_SPELL_POWER ) )
+  if ( specialization() == PALADIN_HOLY )
   {
-    player_t::invalidate_cache( CACHE_ATTACK_POWER );
+    cache.add_dependency( CACHE_INTELLECT, CACHE_ATTACK_POWER );
+    cache.add_dependency( CACHE_SPELL_POWER, CACHE_ATTACK_POWER );
   }
 
-  if ( c == CACHE_ATTACK_CRIT_CHANCE && passives.riposte -> ok() )
-    player_t::invalidate_cache( CACHE_PARRY );
+  if ( passives.riposte -> ok() )
+    cache.add_dependency( CACHE_ATTACK_CRIT_CHANCE, CACHE_PARRY );
 
-  if ( c == CACHE_MASTERY && mastery.divine_bulwark -> ok() )
+  if ( mastery.divine_bulwark -> ok() )
   {
-    player_t::invalidate_cache( CACHE_BLOCK );
-    player_t::invalidate_cache( CACHE_ATTACK_POWER );
-    player_t::invalidate_cache( CACHE_SPELL_POWER );
+    cache.add_dependency( CACHE_MASTERY, CACHE_BLOCK );
+    cache.add_dependency( CACHE_MASTERY, CACHE_ATTACK_POWER );
+    cache.add_dependency( CACHE_MASTERY, CACHE_SPELL_POWER );
   }
 
-  if ( c == CACHE_STRENGTH && spec.shield_of_the_righteous -> ok() )
+  if ( spec.shield_of_the_righteous -> ok() )
   {
-    player_t::invalidate_cache( CACHE_BONUS_ARMOR );
+    cache.add_dependency( CACHE_STRENGTH, CACHE_BONUS_ARMOR );
   }
 }
 
@@ -444,7 +444,7 @@ public:
   virtual void      assess_damage( school_e, result_amount_type, action_state_t* ) override;
   virtual void      target_mitigation( school_e, result_amount_type, action_state_t* ) override;
 
-  virtual void      invalidate_cache( cache_e ) override;
+  virtual void      init_stat_cache() override;
   virtual void      create_options() override;
   virtual double    matching_gear_multiplier( attribute_e attr ) const override;
   virtual void      create_actions() override;
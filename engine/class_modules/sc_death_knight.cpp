@@ -909,7 +909,7 @@ public:
   resource_e primary_resource() const override { return RESOURCE_RUNIC_POWER; }
   role_e    primary_role() const override;
   stat_e    convert_hybrid_stat( stat_e s ) const override;
-  void      invalidate_cache( cache_e ) override;
+  void      init_stat_cache() override;
   double    resource_loss( resource_e resource_type, double amount, gain_t* g = nullptr, action_t* a = nullptr ) override;
   void      copy_from( player_t* other ) override;
   void      merge( player_t& other ) override;
@@ -8601,28 +8601,20 @@ void death_knight_t::combat_begin()
   }
 }
 
-// death_knight_t::invalidate_cache =========================================
+// death_knight_t::init_stat_cache ==========================================
 
-void death_knight_t::invalidate_cache( cache_e c )
+void death_knight_t::init_stat_cache()
 {
-  player_t::invalidate_cache( c );
+  player_t::init_stat_cache();
 
-  switch ( c )
-  {
-    case CACHE_CRIT_CHANCE:
-      if ( spec.riposte -> ok() )
-        player_t::invalidate_cache( CACHE_PARRY );
-      break;
-    case CACHE_MASTERY:
-      if ( specialization() == DEATH_KNIGHT_BLOOD )
-        player_t::invalidate_cache( CACHE_ATTACK_POWER );
-      break;
-    case CACHE_STRENGTH:
-      if ( spell.bone_shield -> ok() )
-        player_t::invalidate_cache( CACHE_BONUS_ARMOR );
-      break;
-    default: break;
-  }
+  if ( spec.riposte -> ok() )
+    cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_PARRY );
+
+  if ( specialization() == DEATH_KNIGHT_BLOOD )
+    cache.add_dependency( CACHE_MASTERY, CACHE_ATTACK_POWER );
+
+  if ( spell.bone_shield -> ok() )
+    cache.add_dependency( CACHE_STRENGTH, CACHE_BONUS_ARMOR );
 }
 
 // death_knight_t::primary_role =============================================
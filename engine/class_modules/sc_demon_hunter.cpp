@@ -536,6 +536,7 @@ public:
   void init_rng() override;
   void init_scaling() override;
   void init_spells() override;
+  void init_stat_cache() override;
   void invalidate_cache( cache_e ) override;
   resource_e primary_resource() const override;
   role_e primary_role() const override;
@@ -4936,6 +4937,19 @@ void demon_hunter_t::init_spells()
   }
 }
 
+// demon_hunter_t::init_stat_cache ==========================================
+
+void demon_hunter_t::init_stat_cache()
+{
+  player_t::init_stat_cache();
+
+  if ( mastery.fel_blood->ok() )
+    cache.add_dependency( CACHE_MASTERY, CACHE_ARMOR );
+
+  if ( spec.riposte->ok() )
+    cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_PARRY );
+}
+
 // demon_hunter_t::invalidate_cache =========================================
 
 void demon_hunter_t::invalidate_cache( cache_e c )
@@ -4945,14 +4959,9 @@ void demon_hunter_t::invalidate_cache( cache_e c )
   switch ( c )
   {
     case CACHE_MASTERY:
+      // Run speed is not a dependency, changing it has to adjust movement
       if ( mastery.demonic_presence->ok() )
         invalidate_cache( CACHE_RUN_SPEED );
-      if ( mastery.fel_blood->ok() )
-        invalidate_cache( CACHE_ARMOR );
-      break;
-    case CACHE_CRIT_CHANCE:
-      if ( spec.riposte->ok() )
-        invalidate_cache( CACHE_PARRY );
       break;
     case CACHE_RUN_SPEED:
       adjust_movement();
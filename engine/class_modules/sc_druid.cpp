@@ -843,6 +843,7 @@ public:
   std::string       default_potion() const override;
   std::string       default_food() const override;
   std::string       default_rune() const override;
+  void      init_stat_cache() override;
   void      invalidate_cache( cache_e ) override;
   void      arise() override;
   void      reset() override;
@@ -9342,6 +9343,25 @@ void druid_t::recalculate_resource_max( resource_e rt )
   }
 }
 
+// druid_t::init_stat_cache ================================================
+
+void druid_t::init_stat_cache()
+{
+  player_t::init_stat_cache();
+
+  if ( specialization() == DRUID_GUARDIAN || specialization() == DRUID_FERAL )
+    cache.add_dependency( CACHE_ATTACK_POWER, CACHE_SPELL_POWER );
+
+  if ( specialization() == DRUID_BALANCE || specialization() == DRUID_RESTORATION )
+    cache.add_dependency( CACHE_SPELL_POWER, CACHE_ATTACK_POWER );
+
+  if ( mastery.natures_guardian -> ok() )
+    cache.add_dependency( CACHE_MASTERY, CACHE_ATTACK_POWER );
+
+  if ( specialization() == DRUID_GUARDIAN )
+    cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_DODGE );
+}
+
 // druid_t::invalidate_cache ================================================
 
 void druid_t::invalidate_cache( cache_e c )
@@ -9350,24 +9370,9 @@ void druid_t::invalidate_cache( cache_e c )
 
   switch ( c )
   {
-  case CACHE_ATTACK_POWER:
-    if ( specialization() == DRUID_GUARDIAN || specialization() == DRUID_FERAL )
-      invalidate_cache( CACHE_SPELL_POWER );
-    break;
-  case CACHE_SPELL_POWER:
-    if ( specialization() == DRUID_BALANCE || specialization() == DRUID_RESTORATION )
-      invalidate_cache( CACHE_ATTACK_POWER );
-    break;
   case CACHE_MASTERY:
     if ( mastery.natures_guardian -> ok() )
-    {
-      invalidate_cache( CACHE_ATTACK_POWER );
       recalculate_resource_max( RESOURCE_HEALTH );
-    }
-    break;
-  case CACHE_CRIT_CHANCE:
-    if ( specialization() == DRUID_GUARDIAN )
-      invalidate_cache( CACHE_DODGE );
     break;
   case CACHE_AGILITY:
     if ( buff.ironfur -> check() )
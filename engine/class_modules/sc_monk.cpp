@@ -838,7 +838,7 @@ public:
   void assess_damage( school_e, result_amount_type, action_state_t* s ) override;
   void assess_damage_imminent_pre_absorb( school_e, result_amount_type, action_state_t* s ) override;
   void assess_heal( school_e, result_amount_type, action_state_t* s ) override;
-  void invalidate_cache( cache_e ) override;
+  void init_stat_cache() override;
   void init_action_list() override;
   void activate() override;
   void collect_resource_timeline_information() override;
@@ -8113,6 +8113,10 @@ void monk_t::init_base_stats()
   }
   base_t::init_base_stats();
 
+  // Sampled in collect_resource_timeline_information(), so use the resource timeline bin size
+  sample_datas.stagger_damage_pct_timeline.set_bin_size( sim->timeline_bin_size );
+  sample_datas.stagger_pct_timeline.set_bin_size( sim->timeline_bin_size );
+
   base_gcd = timespan_t::from_seconds( 1.5 );
 
   switch ( specialization() )
@@ -8997,29 +9001,20 @@ double monk_t::passive_movement_modifier() const
   return ms;
 }
 
-// monk_t::invalidate_cache ==============================================
+// monk_t::init_stat_cache ===============================================
 
-void monk_t::invalidate_cache( cache_e c )
+void monk_t::init_stat_cache()
 {
-  base_t::invalidate_cache( c );
+  base_t::init_stat_cache();
 
-  switch ( c )
-  {
-    case CACHE_SPELL_POWER:
-      if ( specialization() == MONK_MISTWEAVER )
-        player_t::invalidate_cache( CACHE_ATTACK_POWER );
-      break;
-    case CACHE_BONUS_ARMOR:
-      if ( spec.bladed_armor->ok() )
-        player_t::invalidate_cache( CACHE_ATTACK_POWER );
-      break;
-    case CACHE_MASTERY:
-      if ( specialization() == MONK_WINDWALKER )
-        player_t::invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
-      break;
-    default:
-      break;
-  }
+  if ( specialization() == MONK_MISTWEAVER )
+    cache.add_dependency( CACHE_SPELL_POWER, CACHE_ATTACK_POWER );
+
+  if ( spec.bladed_armor->ok() )
+    cache.add_dependency( CACHE_BONUS_ARMOR, CACHE_ATTACK_POWER );
+
+  if ( specialization() == MONK_WINDWALKER )
+    cache.add_dependency( CACHE_MASTERY, CACHE_PLAYER_DAMAGE_MULTIPLIER );
 }
 
 // monk_t::create_options ===================================================
@@ -558,7 +558,7 @@ public:
   void moving() override;
   void create_options() override;
   std::string create_profile( save_e type ) override;
-  void invalidate_cache( cache_e ) override;
+  void init_stat_cache() override;
   double temporary_movement_modifier() const override;
   void vision_of_perfection_proc() override;
 
@@ -6641,32 +6641,26 @@ double warrior_t::temporary_movement_modifier() const
   return temporary;
 }
 
-// warrior_t::invalidate_cache ==============================================
+// warrior_t::init_stat_cache ==============================================
 
-void warrior_t::invalidate_cache( cache_e c )
+void warrior_t::init_stat_cache()
 {
-  player_t::invalidate_cache( c );
+  player_t::init_stat_cache();
 
   if ( mastery.critical_block->ok() )
   {
-    if ( c == CACHE_MASTERY )
-    {
-      player_t::invalidate_cache( CACHE_BLOCK );
-      player_t::invalidate_cache( CACHE_CRIT_BLOCK );
-      player_t::invalidate_cache( CACHE_ATTACK_POWER );
-    }
-    if ( c == CACHE_CRIT_CHANCE )
-    {
-      player_t::invalidate_cache( CACHE_PARRY );
-    }
+    cache.add_dependency( CACHE_MASTERY, CACHE_BLOCK );
+    cache.add_dependency( CACHE_MASTERY, CACHE_CRIT_BLOCK );
+    cache.add_dependency( CACHE_MASTERY, CACHE_ATTACK_POWER );
+    cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_PARRY );
   }
-  if ( c == CACHE_MASTERY && mastery.unshackled_fury->ok() )
+  if ( mastery.unshackled_fury->ok() )
   {
-    player_t::invalidate_cache( CACHE_PLAYER_DAMAGE_MULTIPLIER );
+    cache.add_dependency( CACHE_MASTERY, CACHE_PLAYER_DAMAGE_MULTIPLIER );
   }
-  if ( c == CACHE_STRENGTH && spec.vanguard -> ok() )
+  if ( spec.vanguard -> ok() )
   {
-    player_t::invalidate_cache( CACHE_BONUS_ARMOR );
+    cache.add_dependency( CACHE_STRENGTH, CACHE_BONUS_ARMOR );
   }
 }
 
@@ -448,7 +448,7 @@ namespace warlock
       double    composite_player_target_multiplier( player_t* target, school_e school ) const override;
       double    composite_player_pet_damage_multiplier( const action_state_t* ) const override;
       double    composite_rating_multiplier( rating_e rating ) const override;
-      void      invalidate_cache( cache_e ) override;
+      void      init_stat_cache() override;
       double    composite_spell_crit_chance() const override;
       double    composite_spell_haste() const override;
       double    composite_melee_haste() const override;
@@ -1776,26 +1776,44 @@ template <typename T, typename KeyPolicy = id_function_policy>
 class dbc_index_t
 {
 private:
+  // Lists with at most this many ids per entry are looked up through a direct id -> data table
+  static const unsigned DIRECT_INDEX_DENSITY = 4;
+
   typedef std::pair<T*, T*> index_t; // first = lowest data; second = highest data
 // array of size 1 or 2, depending on whether we have PTR data
 #if SC_USE_PTR == 0
   index_t idx[ 1 ];
+  std::vector<T*> direct[ 1 ];
 #else
   index_t idx[ 2 ];
+  std::vector<T*> direct[ 2 ];
 #endif
 
   /* populate idx with pointer to lowest and highest data from a given list
    */
-  void populate( index_t& idx, T* list )
+  void populate( index_t& idx, std::vector<T*>& direct, T* list )
   {
     assert( list );
     idx.first = list;
-    for ( unsigned last_id = 0; KeyPolicy::id( *list ); last_id = KeyPolicy::id( *list ), ++list )
+    unsigned last_id = 0;
+    for ( ; KeyPolicy::id( *list ); last_id = KeyPolicy::id( *list ), ++list )
     {
       // Validate the input range is in fact sorted by id.
-      assert( KeyPolicy::id( *list ) > last_id ); ( void )last_id;
+      assert( KeyPolicy::id( *list ) > last_id );
     }
     idx.second = list;
+
+    // Dense enough id ranges (e.g. spells) are indexed directly, sparse ones keep using binary
+    // search on the sorted list.
+    size_t n_entries = idx.second - idx.first;
+    if ( n_entries > 0 && last_id / DIRECT_INDEX_DENSITY <= n_entries )
+    {
+      direct.assign( last_id + 1, nullptr );
+      for ( T* p = idx.first; p != idx.second; ++p )
+      {
+        direct[ KeyPolicy::id( *p ) ] = p;
+      }
+    }
   }
 
 public:
@@ -1803,7 +1821,7 @@ public:
   void init( T* list, bool ptr )
   {
     assert( ! initialized( maybe_ptr( ptr ) ) );
-    populate( idx[ maybe_ptr( ptr ) ], list );
+    populate( idx[ maybe_ptr( ptr ) ], direct[ maybe_ptr( ptr ) ], list );
   }
 
   // Initialize index under the assumption that 'T::list( bool ptr )' returns a list of data
@@ -1821,6 +1839,12 @@ public:
   T* get( bool ptr, unsigned id ) const
   {
     assert( initialized( maybe_ptr( ptr ) ) );
+    const std::vector<T*>& d = direct[ maybe_ptr( ptr ) ];
+    if ( ! d.empty() )
+    {
+      return id < d.size() ? d[ id ] : nullptr;
+    }
+
     T* p = std::lower_bound( idx[ maybe_ptr( ptr ) ].first, idx[ maybe_ptr( ptr ) ].second, id, id_compare<T, KeyPolicy>() );
     if ( p != idx[ maybe_ptr( ptr ) ].second && KeyPolicy::id( *p ) == id )
       return p;
@@ -159,6 +159,86 @@ spell_mapping_reference_t<spell_data_t, unsigned> spell_categories_index(
     return 0U;
   }
 );
+
+// Name and position indexes built by dbc::init(), replacing linear scans over the client data.
+// Name keys point into the static client data, so the tables hash the C strings themselves.
+struct cstr_hash_t
+{
+  size_t operator()( const char* str ) const
+  {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for ( ; *str; ++str )
+    {
+      hash = ( hash ^ static_cast<unsigned char>( *str ) ) * 1099511628211ULL;
+    }
+    return static_cast<size_t>( hash );
+  }
+};
+
+struct cstr_equal_t
+{
+  bool operator()( const char* l, const char* r ) const
+  { return std::strcmp( l, r ) == 0; }
+};
+
+// First spell of a given name, in client data order
+std::unordered_map<const char*, spell_data_t*, cstr_hash_t, cstr_equal_t> spell_name_index[ 2 ];
+
+// All talents of a given (tokenized) name, in client data order
+std::unordered_map<const char*, std::vector<talent_data_t*>, cstr_hash_t, cstr_equal_t> talent_name_index[ 2 ];
+std::unordered_map<std::string, std::vector<talent_data_t*>> talent_token_index[ 2 ];
+
+// First talent of a given class, row, column and specialization, in client data order. Talents
+// are also indexed with TALENT_ANY_SPEC for lookups that ignore the specialization.
+const unsigned TALENT_ANY_SPEC = 0xFFFFFFFF;
+std::unordered_map<uint64_t, talent_data_t*> talent_position_index[ 2 ];
+
+uint64_t talent_position_key( player_e c, unsigned row, unsigned col, unsigned spec )
+{
+  return ( static_cast<uint64_t>( c ) << 48 ) | ( static_cast<uint64_t>( row & 0xFF ) << 40 ) |
+         ( static_cast<uint64_t>( col & 0xFF ) << 32 ) | spec;
+}
+
+void init_name_indexes( bool ptr )
+{
+  auto& spells = spell_name_index[ ptr ];
+  for ( spell_data_t* p = spell_data_t::list( ptr ); p -> name_cstr(); ++p )
+  {
+    spells.emplace( p -> name_cstr(), p );
+  }
+
+  auto& names = talent_name_index[ ptr ];
+  auto& tokens = talent_token_index[ ptr ];
+  auto& positions = talent_position_index[ ptr ];
+  for ( talent_data_t* p = talent_data_t::list( ptr ); p -> name_cstr(); ++p )
+  {
+    names[ p -> name_cstr() ].push_back( p );
+
+    std::string tokenized_name = p -> name_cstr();
+    util::tokenize( tokenized_name );
+    tokens[ tokenized_name ].push_back( p );
+
+    for ( int i = PLAYER_NONE; i < PLAYER_MAX; ++i )
+    {
+      auto c = static_cast<player_e>( i );
+      if ( ! p -> is_class( c ) )
+      {
+        continue;
+      }
+
+      positions.emplace( talent_position_key( c, p -> row(), p -> col(), p -> specialization() ), p );
+      positions.emplace( talent_position_key( c, p -> row(), p -> col(), TALENT_ANY_SPEC ), p );
+    }
+  }
+}
+
+talent_data_t* find_talent( const std::vector<talent_data_t*>& talents, specialization_e spec )
+{
+  auto it = range::find_if( talents, [ spec ]( const talent_data_t* t ) { return t -> specialization() == spec; } );
+  return it != talents.end() ? *it : nullptr;
+}
+
 struct class_passives_entry_t
   {
     player_e         type;
@@ -295,6 +375,11 @@ void dbc::init()
   power_data_index.init();
   init_item_data();
 
+  // Name and talent position indexes
+  init_name_indexes( false );
+  if ( SC_USE_PTR )
+    init_name_indexes( true );
+
   // runtime linking, eg. from spell_data to all its effects
   spell_data_t::link( false );
   spelleffect_data_t::link( false );
@@ -1927,14 +2012,9 @@ spell_data_t* spell_data_t::find( unsigned spell_id, const char* confirmation, b
 
 spell_data_t* spell_data_t::find( const char* name, bool ptr )
 {
-  for ( spell_data_t* p = spell_data_t::list( ptr ); p -> name_cstr(); ++p )
-  {
-    if ( ! strcmp ( name, p -> name_cstr() ) )
-    {
-      return p;
-    }
-  }
-  return nullptr;
+  const auto& index = spell_name_index[ maybe_ptr( ptr ) ];
+  auto it = index.find( name );
+  return it != index.end() ? it -> second : nullptr;
 }
 
 // Always returns non-NULL
@@ -1955,35 +2035,18 @@ spellpower_data_t* spellpower_data_t::find( unsigned id, bool ptr )
 
 talent_data_t* talent_data_t::find( player_e c, unsigned int row, unsigned int col, specialization_e spec, bool ptr )
 {
-  talent_data_t* talent_data = talent_data_t::list( ptr );
+  const auto& index = talent_position_index[ maybe_ptr( ptr ) ];
 
-  for ( unsigned k = 0; talent_data[ k ].name_cstr(); k++ )
+  auto it = index.find( talent_position_key( c, row, col, spec ) );
+  if ( it != index.end() )
   {
-    talent_data_t& td = talent_data[ k ];
-    if ( td.is_class( c ) && ( row == td.row() ) && ( col == td.col() ) && spec == td.specialization() )
-    {
-      return &td;
-    }
+    return it -> second;
   }
 
   // Second round to check all talents, either with a none spec, or no spec check at all,
   // depending on what the caller gave in "spec" parameter
-  for ( unsigned k = 0; talent_data[ k ].name_cstr(); k++ )
-  {
-    talent_data_t& td = talent_data[ k ];
-    if ( spec != SPEC_NONE )
-    {
-      if ( td.is_class( c ) && ( row == td.row() ) && ( col == td.col() ) && td.specialization() == SPEC_NONE )
-        return &td;
-    }
-    else
-    {
-      if ( td.is_class( c ) && ( row == td.row() ) && ( col == td.col() ) )
-        return &td;
-    }
-  }
-
-  return nullptr;
+  it = index.find( talent_position_key( c, row, col, spec != SPEC_NONE ? static_cast<unsigned>( SPEC_NONE ) : TALENT_ANY_SPEC ) );
+  return it != index.end() ? it -> second : nullptr;
 }
 
 talent_data_t* talent_data_t::find( unsigned id, bool ptr )
@@ -2005,28 +2068,20 @@ talent_data_t* talent_data_t::find( unsigned id, const char* confirmation, bool
 
 talent_data_t* talent_data_t::find( const char* name_cstr, specialization_e spec, bool ptr )
 {
-  for ( talent_data_t* p = talent_data_t::list( ptr ); p -> name_cstr(); ++p )
-  {
-    if ( ! strcmp( name_cstr, p -> name_cstr() ) && p -> specialization() == spec )
-    {
-      return p;
-    }
-  }
-
-  return nullptr;
+  const auto& index = talent_name_index[ maybe_ptr( ptr ) ];
+  auto it = index.find( name_cstr );
+  return it != index.end() ? find_talent( it -> second, spec ) : nullptr;
 }
 
 talent_data_t* talent_data_t::find_tokenized( const char* name, specialization_e spec, bool ptr )
 {
-  for ( talent_data_t* p = talent_data_t::list( ptr ); p -> name_cstr(); ++p )
-  {
-    std::string tokenized_name = p -> name_cstr();
-    util::tokenize( tokenized_name );
-    if ( util::str_compare_ci( name, tokenized_name ) && p -> specialization() == spec )
-      return p;
-  }
+  // Tokenized names are lower case, which makes the lookup case insensitive
+  std::string tokenized_name = name;
+  util::tolower( tokenized_name );
 
-  return nullptr;
+  const auto& index = talent_token_index[ maybe_ptr( ptr ) ];
+  auto it = index.find( tokenized_name );
+  return it != index.end() ? find_talent( it -> second, spec ) : nullptr;
 }
 
 void spell_data_t::link( bool ptr )
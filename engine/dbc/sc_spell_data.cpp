@@ -3,6 +3,8 @@
 // Send questions to natehieter@gmail.com
 // ==========================================================================
 
+#include <unordered_set>
+
 #include "simulationcraft.hpp"
 #include "sim/sc_expressions.hpp"
 
@@ -646,10 +648,13 @@ struct spell_data_filter_expr_t : public spell_list_expr_t
 
   void build_list( std::vector<uint32_t>& res, const spell_data_expr_t& other, expression::token_e t ) const
   {
+    // Result set membership, a linear search of res made queries matching most spells quadratic
+    std::unordered_set<uint32_t> in_result( res.begin(), res.end() );
+
     for ( const auto& result_spell : result_spell_list )
     {
       // Don't bother comparing if this spell id is already in the result set.
-      if ( range::find( res, result_spell ) != res.end() )
+      if ( in_result.count( result_spell ) )
         continue;
 
       if ( effect_query )
@@ -665,6 +670,7 @@ struct spell_data_filter_expr_t : public spell_list_expr_t
                compare( reinterpret_cast<const char*>( &effect ), other, t ) )
           {
             res.push_back( result_spell );
+            in_result.insert( result_spell );
             break;
           }
         }
@@ -679,7 +685,10 @@ struct spell_data_filter_expr_t : public spell_list_expr_t
         else
           p_data = reinterpret_cast<const char*>( sim -> dbc.spell( result_spell ) );
         if ( p_data && compare( p_data, other, t ) )
+        {
           res.push_back( result_spell );
+          in_result.insert( result_spell );
+        }
       }
     }
   }
@@ -264,6 +264,10 @@ public:
       v_.AddMember( rapidjson::StringRef( "std_dev" ), v.std_dev, d_.GetAllocator() );
       v_.AddMember( rapidjson::StringRef( "mean_variance" ), v.mean_variance, d_.GetAllocator() );
       v_.AddMember( rapidjson::StringRef( "mean_std_dev" ), v.mean_std_dev, d_.GetAllocator() );
+      if ( v.sketched() )
+      {
+        v_.AddMember( rapidjson::StringRef( "percentile_rank_error" ), v.rank_error_bound(), d_.GetAllocator() );
+      }
     }
 
     return *this;
@@ -332,9 +336,10 @@ public:
     v_.AddMember( rapidjson::StringRef( "max" ), v.max(), d_.GetAllocator() );
 
     rapidjson::Value data_arr( rapidjson::kArrayType );
-    range::for_each( v.data(), [ &data_arr, this ]( double dp ) {
+    for ( double dp : v.data() )
+    {
       data_arr.PushBack( dp, d_.GetAllocator() );
-    } );
+    }
 
     v_.AddMember( rapidjson::StringRef( "data" ), data_arr, d_.GetAllocator() );
     return *this;
@@ -1992,6 +1992,12 @@ void player_t::init_resources( bool force )
           collected_data.resource_timelines.emplace_back( resource );
         }
       }
+
+      for ( auto& tl : collected_data.resource_timelines )
+      {
+        tl.timeline.set_bin_size( sim->timeline_bin_size );
+        tl.timeline.attach( sim->timeline_arena );
+      }
     }
   }
 }
@@ -2431,6 +2437,55 @@ void player_t::init_stats()
   collected_data.reserve_memory( *this );
 }
 
+/**
+ * Build the stat cache dependency graph.
+ *
+ * Invalidating a cache also invalidates all caches added as its dependents, transitively. This should be
+ * overwritten in class modules to add invalidation chains that only depend on spec and talents, eg. a mastery
+ * that modifies attack power.
+ */
+void player_t::init_stat_cache()
+{
+  if ( initial.attack_power_per_strength > 0 )
+    cache.add_dependency( CACHE_STRENGTH, CACHE_ATTACK_POWER );
+  if ( initial.parry_per_strength > 0 )
+    cache.add_dependency( CACHE_STRENGTH, CACHE_PARRY );
+
+  if ( initial.attack_power_per_agility > 0 )
+    cache.add_dependency( CACHE_AGILITY, CACHE_ATTACK_POWER );
+  if ( initial.dodge_per_agility > 0 )
+    cache.add_dependency( CACHE_AGILITY, CACHE_DODGE );
+  if ( initial.spell_power_per_attack_power > 0 )
+  {
+    cache.add_dependency( CACHE_AGILITY, CACHE_SPELL_POWER );
+    cache.add_dependency( CACHE_AGILITY, CACHE_ATTACK_POWER );
+  }
+
+  if ( initial.spell_power_per_intellect > 0 )
+    cache.add_dependency( CACHE_INTELLECT, CACHE_SPELL_POWER );
+
+  cache.add_dependency( CACHE_ATTACK_HASTE, CACHE_ATTACK_SPEED );
+  cache.add_dependency( CACHE_ATTACK_HASTE, CACHE_RPPM_HASTE );
+  cache.add_dependency( CACHE_SPELL_HASTE, CACHE_SPELL_SPEED );
+  cache.add_dependency( CACHE_SPELL_HASTE, CACHE_RPPM_HASTE );
+  cache.add_dependency( CACHE_BONUS_ARMOR, CACHE_ARMOR );
+  cache.add_dependency( CACHE_ATTACK_CRIT_CHANCE, CACHE_RPPM_CRIT );
+  cache.add_dependency( CACHE_SPELL_CRIT_CHANCE, CACHE_RPPM_CRIT );
+
+  // Rating caches that feed into the melee and spell variants
+  cache.add_dependency( CACHE_EXP, CACHE_ATTACK_EXP );
+  cache.add_dependency( CACHE_EXP, CACHE_SPELL_HIT );
+  cache.add_dependency( CACHE_HIT, CACHE_ATTACK_HIT );
+  cache.add_dependency( CACHE_HIT, CACHE_SPELL_HIT );
+  cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_ATTACK_CRIT_CHANCE );
+  cache.add_dependency( CACHE_CRIT_CHANCE, CACHE_SPELL_CRIT_CHANCE );
+  cache.add_dependency( CACHE_HASTE, CACHE_ATTACK_HASTE );
+  cache.add_dependency( CACHE_HASTE, CACHE_SPELL_HASTE );
+  cache.add_dependency( CACHE_VERSATILITY, CACHE_DAMAGE_VERSATILITY );
+  cache.add_dependency( CACHE_VERSATILITY, CACHE_HEAL_VERSATILITY );
+  cache.add_dependency( CACHE_VERSATILITY, CACHE_MITIGATION_VERSATILITY );
+}
+
 /**
  * Define absorb priority.
  *
@@ -2728,8 +2783,8 @@ void player_t::create_actions()
   if ( !is_add() && ( !is_pet() || sim->report_pets_separately ) )
   {
     int capacity = std::max( 1200, static_cast<int>( sim->max_time.total_seconds() / 2.0 ) );
-    collected_data.action_sequence.reserve( capacity );
     collected_data.action_sequence.clear();
+    collected_data.action_sequence.reserve( capacity );
   }
 }
 
@@ -2915,7 +2970,13 @@ void player_t::init_assessors()
     proc_types pt   = state->proc_type();
     proc_types2 pt2 = state->impact_proc_type2();
     if ( pt != PROC1_INVALID && pt2 != PROC2_INVALID )
-      action_callback_t::trigger( callbacks.procs[ pt ][ pt2 ], state->action, state );
+    {
+      // Outgoing callbacks of the action's own player go through the action's dispatch table
+      if ( state->action->player == this )
+        state->action->trigger_callbacks( pt, pt2, state );
+      else
+        action_callback_t::trigger( callbacks.procs[ pt ][ pt2 ], state->action, state );
+    }
 
     return assessor::CONTINUE;
   } );
@@ -2975,6 +3036,10 @@ void player_t::init_finished()
   // Sort outbound assessors
   assessor_out_damage.sort();
 
+  init_stat_cache();
+  cache.finalize_dependencies();
+  cache.counting = sim->report_stat_cache != 0;
+
   // Print items to debug log
   if ( sim->debug )
   {
@@ -4306,79 +4371,8 @@ void player_t::invalidate_cache( cache_e c )
 
   sim->print_debug( "{} invalidates stat cache for {}.", *this, util::cache_type_string( c ) );
 
-  // Special linked invalidations
-  switch ( c )
-  {
-    case CACHE_STRENGTH:
-      if ( current.attack_power_per_strength > 0 )
-        invalidate_cache( CACHE_ATTACK_POWER );
-      if ( current.parry_per_strength > 0 )
-        invalidate_cache( CACHE_PARRY );
-      break;
-    case CACHE_AGILITY:
-      if ( current.attack_power_per_agility > 0 )
-        invalidate_cache( CACHE_ATTACK_POWER );
-      if ( current.dodge_per_agility > 0 )
-        invalidate_cache( CACHE_DODGE );
-      if ( current.spell_power_per_attack_power > 0 )
-      {
-        invalidate_cache( CACHE_SPELL_POWER );
-        invalidate_cache( CACHE_ATTACK_POWER );
-      }
-      break;
-    case CACHE_INTELLECT:
-      if ( current.spell_power_per_intellect > 0 )
-        invalidate_cache( CACHE_SPELL_POWER );
-      break;
-    case CACHE_ATTACK_HASTE:
-      invalidate_cache( CACHE_ATTACK_SPEED );
-      invalidate_cache( CACHE_RPPM_HASTE );
-      break;
-    case CACHE_SPELL_HASTE:
-      invalidate_cache( CACHE_SPELL_SPEED );
-      invalidate_cache( CACHE_RPPM_HASTE );
-      break;
-    case CACHE_BONUS_ARMOR:
-      invalidate_cache( CACHE_ARMOR );
-      break;
-    case CACHE_ATTACK_CRIT_CHANCE:
-      invalidate_cache( CACHE_RPPM_CRIT );
-      break;
-    case CACHE_SPELL_CRIT_CHANCE:
-      invalidate_cache( CACHE_RPPM_CRIT );
-      break;
-    default:
-      break;
-  }
-
-  // Normal invalidation of the corresponding Cache
-  switch ( c )
-  {
-    case CACHE_EXP:
-      invalidate_cache( CACHE_ATTACK_EXP );
-      invalidate_cache( CACHE_SPELL_HIT );
-      break;
-    case CACHE_HIT:
-      invalidate_cache( CACHE_ATTACK_HIT );
-      invalidate_cache( CACHE_SPELL_HIT );
-      break;
-    case CACHE_CRIT_CHANCE:
-      invalidate_cache( CACHE_ATTACK_CRIT_CHANCE );
-      invalidate_cache( CACHE_SPELL_CRIT_CHANCE );
-      break;
-    case CACHE_HASTE:
-      invalidate_cache( CACHE_ATTACK_HASTE );
-      invalidate_cache( CACHE_SPELL_HASTE );
-      break;
-    case CACHE_VERSATILITY:
-      invalidate_cache( CACHE_DAMAGE_VERSATILITY );
-      invalidate_cache( CACHE_HEAL_VERSATILITY );
-      invalidate_cache( CACHE_MITIGATION_VERSATILITY );
-      break;
-    default:
-      cache.invalidate( c );
-      break;
-  }
+  // Clears c and all its dependents, see player_t::init_stat_cache()
+  cache.invalidate( c );
 }
 #else
 void invalidate_cache( cache_e )
@@ -4395,13 +4389,7 @@ void player_t::sequence_add_wait( const timespan_t& amount, const timespan_t& ts
     if ( collected_data.action_sequence.size() <= sim->expected_max_time() * 2.0 + 3.0 )
     {
       if ( in_combat )
-      {
-        if ( collected_data.action_sequence.size() &&
-             collected_data.action_sequence.back().wait_time > timespan_t::zero() )
-          collected_data.action_sequence.back().wait_time += amount;
-        else
-          collected_data.action_sequence.emplace_back( ts, amount, this );
-      }
+        collected_data.action_sequence.add_wait( ts, amount, this );
     }
     else
     {
@@ -4422,9 +4410,9 @@ void player_t::sequence_add( const action_t* a, const player_t* target, const ti
     if ( collected_data.action_sequence.size() <= sim->expected_max_time() * 2.0 + 3.0 )
     {
       if ( in_combat )
-        collected_data.action_sequence.emplace_back( a, target, ts, this );
+        collected_data.action_sequence.add( a, target, ts, this );
       else
-        collected_data.action_sequence_precombat.emplace_back( a, target, ts, this );
+        collected_data.action_sequence_precombat.add( a, target, ts, this );
     }
     else
     {
@@ -4447,7 +4435,9 @@ void player_t::combat_begin()
 
   init_resources( true );
 
-  // Execute pre-combat actions
+  // Execute pre-combat actions. They run every iteration, even when deterministic: their effects
+  // live in class module state, pets and queued events, so a combat start snapshot could not be
+  // restored without missing state.
   if ( !is_pet() && !is_add() )
   {
     for ( auto& action : precombat_action_list )
@@ -4825,6 +4815,8 @@ void player_t::merge( player_t& other )
 
   buff_merge::merge( *this, other );
 
+  cache.merge( other.cache );
+
   // Procs
   for ( size_t i = 0; i < proc_list.size(); ++i )
   {
@@ -4922,6 +4914,8 @@ void player_t::merge( player_t& other )
     if ( action_list[ i ]->internal_id == other.action_list[ i ]->internal_id )
     {
       action_list[ i ]->total_executions += other.action_list[ i ]->total_executions;
+      action_list[ i ]->callbacks_checked += other.action_list[ i ]->callbacks_checked;
+      action_list[ i ]->callbacks_fired += other.action_list[ i ]->callbacks_fired;
     }
     else
     {
@@ -4961,8 +4955,7 @@ void player_t::reset()
 
   sim->print_debug( "{} resets current stats ( reset to initial ): {}", *this, current.to_string() );
 
-  for ( auto& buff : buff_list )
-    buff->reset();
+  buff_t::reset_buffs( *sim, buff_list, dirty_buffs );
 
   last_foreground_action = nullptr;
   prev_gcd_actions.clear();
@@ -4996,8 +4989,7 @@ void player_t::reset()
   off_hand_weapon.buff_value = 0;
   off_hand_weapon.bonus_dmg  = 0;
 
-  x_position = default_x_position;
-  y_position = default_y_position;
+  set_position( default_x_position, default_y_position );
 
   callbacks.reset();
 
@@ -11913,6 +11905,28 @@ void player_t::do_update_movement( double yards )
   }
 }
 
+player_stat_cache_t::player_stat_cache_t( const player_t* p ) :
+  player( p ),
+  valid( 0 ),
+  spell_power_valid( 0 ),
+  player_mult_valid( 0 ),
+  player_heal_mult_valid( 0 ),
+  _value(),
+  _mastery_value( 0 ),
+  _spell_power(),
+  _player_mult(),
+  _player_heal_mult(),
+  dependents_finalized( false ),
+  active( false ),
+  counting( false ),
+  hits(),
+  misses(),
+  invalidations()
+{
+  // Until the dependency graph is finalized, every invalidation clears the whole cache
+  range::fill( dependents, ~mask_t( 0 ) );
+}
+
 /**
  * Invalidate cache for ALL stats.
  */
@@ -11921,31 +11935,85 @@ void player_stat_cache_t::invalidate_all()
   if ( !active )
     return;
 
-  range::fill( valid, false );
-  range::fill( spell_power_valid, false );
-  range::fill( player_mult_valid, false );
-  range::fill( player_heal_mult_valid, false );
+  valid                  = 0;
+  spell_power_valid      = 0;
+  player_mult_valid      = 0;
+  player_heal_mult_valid = 0;
 }
 
 /**
- * Invalidate cache for a specific cache.
+ * Invalidate cache for a specific cache, and all caches depending on it.
  */
 void player_stat_cache_t::invalidate( cache_e c )
 {
-  switch ( c )
+  if ( counting )
+    ++invalidations[ c ];
+
+  mask_t mask = dependents[ c ];
+  valid &= ~mask;
+  if ( mask & bit( CACHE_SPELL_POWER ) )
+    spell_power_valid = 0;
+  if ( mask & bit( CACHE_PLAYER_DAMAGE_MULTIPLIER ) )
+    player_mult_valid = 0;
+  if ( mask & bit( CACHE_PLAYER_HEAL_MULTIPLIER ) )
+    player_heal_mult_valid = 0;
+}
+
+/**
+ * Invalidating c also invalidates dependent. Only valid before finalize_dependencies().
+ */
+void player_stat_cache_t::add_dependency( cache_e c, cache_e dependent )
+{
+  assert( !dependents_finalized && "Stat cache dependencies must be added in player_t::init_stat_cache()" );
+
+  if ( dependents[ c ] == ~mask_t( 0 ) )
+    dependents[ c ] = bit( c );
+
+  dependents[ c ] |= bit( dependent );
+}
+
+/**
+ * Compute the transitive closure of the dependency graph, so a single mask clears every dependent.
+ */
+void player_stat_cache_t::finalize_dependencies()
+{
+  for ( unsigned c = 0; c < CACHE_MAX; ++c )
   {
-    case CACHE_SPELL_POWER:
-      range::fill( spell_power_valid, false );
-      break;
-    case CACHE_PLAYER_DAMAGE_MULTIPLIER:
-      range::fill( player_mult_valid, false );
-      break;
-    case CACHE_PLAYER_HEAL_MULTIPLIER:
-      range::fill( player_heal_mult_valid, false );
-      break;
-    default:
-      valid[ c ] = false;
-      break;
+    if ( dependents[ c ] == ~mask_t( 0 ) )
+      dependents[ c ] = bit( c );
+  }
+
+  bool changed = true;
+  while ( changed )
+  {
+    changed = false;
+    for ( auto& mask : dependents )
+    {
+      mask_t closure = mask;
+      for ( unsigned d = 0; d < CACHE_MAX; ++d )
+      {
+        if ( mask & bit( d ) )
+          closure |= dependents[ d ];
+      }
+
+      if ( closure != mask )
+      {
+        mask    = closure;
+        changed = true;
+      }
+    }
+  }
+
+  dependents_finalized = true;
+}
+
+void player_stat_cache_t::merge( const player_stat_cache_t& other )
+{
+  for ( unsigned c = 0; c < CACHE_MAX; ++c )
+  {
+    hits[ c ] += other.hits[ c ];
+    misses[ c ] += other.misses[ c ];
+    invalidations[ c ] += other.invalidations[ c ];
   }
 }
 
@@ -11977,325 +12045,140 @@ double player_stat_cache_t::get_attribute( attribute_e a ) const
 
 double player_stat_cache_t::strength() const
 {
-  if ( !active || !valid[ CACHE_STRENGTH ] )
-  {
-    valid[ CACHE_STRENGTH ] = true;
-    _strength               = player->strength();
-  }
-  else
-    assert( _strength == player->strength() );
-  return _strength;
+  return get( CACHE_STRENGTH, [ this ] { return player->strength(); } );
 }
 
 double player_stat_cache_t::agility() const
 {
-  if ( !active || !valid[ CACHE_AGILITY ] )
-  {
-    valid[ CACHE_AGILITY ] = true;
-    _agility               = player->agility();
-  }
-  else
-    assert( _agility == player->agility() );
-  return _agility;
+  return get( CACHE_AGILITY, [ this ] { return player->agility(); } );
 }
 
 double player_stat_cache_t::stamina() const
 {
-  if ( !active || !valid[ CACHE_STAMINA ] )
-  {
-    valid[ CACHE_STAMINA ] = true;
-    _stamina               = player->stamina();
-  }
-  else
-    assert( _stamina == player->stamina() );
-  return _stamina;
+  return get( CACHE_STAMINA, [ this ] { return player->stamina(); } );
 }
 
 double player_stat_cache_t::intellect() const
 {
-  if ( !active || !valid[ CACHE_INTELLECT ] )
-  {
-    valid[ CACHE_INTELLECT ] = true;
-    _intellect               = player->intellect();
-  }
-  else
-    assert( _intellect == player->intellect() );
-  return _intellect;
+  return get( CACHE_INTELLECT, [ this ] { return player->intellect(); } );
 }
 
 double player_stat_cache_t::spirit() const
 {
-  if ( !active || !valid[ CACHE_SPIRIT ] )
-  {
-    valid[ CACHE_SPIRIT ] = true;
-    _spirit               = player->spirit();
-  }
-  else
-    assert( _spirit == player->spirit() );
-  return _spirit;
+  return get( CACHE_SPIRIT, [ this ] { return player->spirit(); } );
 }
 
 double player_stat_cache_t::spell_power( school_e s ) const
 {
-  if ( !active || !spell_power_valid[ s ] )
-  {
-    spell_power_valid[ s ] = true;
-    _spell_power[ s ]      = player->composite_spell_power( s );
-  }
-  else
-    assert( _spell_power[ s ] == player->composite_spell_power( s ) );
-  return _spell_power[ s ];
+  return get_school( CACHE_SPELL_POWER, spell_power_valid, _spell_power, s,
+                     [ this, s ] { return player->composite_spell_power( s ); } );
 }
 
 double player_stat_cache_t::attack_power() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_POWER ] )
-  {
-    valid[ CACHE_ATTACK_POWER ] = true;
-    _attack_power               = player->composite_melee_attack_power();
-  }
-  else
-    assert( _attack_power == player->composite_melee_attack_power() );
-  return _attack_power;
+  return get( CACHE_ATTACK_POWER, [ this ] { return player->composite_melee_attack_power(); } );
 }
 
 double player_stat_cache_t::attack_expertise() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_EXP ] )
-  {
-    valid[ CACHE_ATTACK_EXP ] = true;
-    _attack_expertise         = player->composite_melee_expertise();
-  }
-  else
-    assert( _attack_expertise == player->composite_melee_expertise() );
-  return _attack_expertise;
+  return get( CACHE_ATTACK_EXP, [ this ] { return player->composite_melee_expertise(); } );
 }
 
 double player_stat_cache_t::attack_hit() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_HIT ] )
-  {
-    valid[ CACHE_ATTACK_HIT ] = true;
-    _attack_hit               = player->composite_melee_hit();
-  }
-  else
-  {
-    if ( _attack_hit != player->composite_melee_hit() )
-    {
-      assert( false );
-    }
-    // assert( _attack_hit == player -> composite_attack_hit() );
-  }
-  return _attack_hit;
+  return get( CACHE_ATTACK_HIT, [ this ] { return player->composite_melee_hit(); } );
 }
 
 double player_stat_cache_t::attack_crit_chance() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_CRIT_CHANCE ] )
-  {
-    valid[ CACHE_ATTACK_CRIT_CHANCE ] = true;
-    _attack_crit_chance               = player->composite_melee_crit_chance();
-  }
-  else
-    assert( _attack_crit_chance == player->composite_melee_crit_chance() );
-  return _attack_crit_chance;
+  return get( CACHE_ATTACK_CRIT_CHANCE, [ this ] { return player->composite_melee_crit_chance(); } );
 }
 
 double player_stat_cache_t::attack_haste() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_HASTE ] )
-  {
-    valid[ CACHE_ATTACK_HASTE ] = true;
-    _attack_haste               = player->composite_melee_haste();
-  }
-  else
-    assert( _attack_haste == player->composite_melee_haste() );
-  return _attack_haste;
+  return get( CACHE_ATTACK_HASTE, [ this ] { return player->composite_melee_haste(); } );
 }
 
 double player_stat_cache_t::attack_speed() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_SPEED ] )
-  {
-    valid[ CACHE_ATTACK_SPEED ] = true;
-    _attack_speed               = player->composite_melee_speed();
-  }
-  else
-    assert( _attack_speed == player->composite_melee_speed() );
-  return _attack_speed;
+  return get( CACHE_ATTACK_SPEED, [ this ] { return player->composite_melee_speed(); } );
 }
 
 double player_stat_cache_t::spell_hit() const
 {
-  if ( !active || !valid[ CACHE_SPELL_HIT ] )
-  {
-    valid[ CACHE_SPELL_HIT ] = true;
-    _spell_hit               = player->composite_spell_hit();
-  }
-  else
-    assert( _spell_hit == player->composite_spell_hit() );
-  return _spell_hit;
+  return get( CACHE_SPELL_HIT, [ this ] { return player->composite_spell_hit(); } );
 }
 
 double player_stat_cache_t::spell_crit_chance() const
 {
-  if ( !active || !valid[ CACHE_SPELL_CRIT_CHANCE ] )
-  {
-    valid[ CACHE_SPELL_CRIT_CHANCE ] = true;
-    _spell_crit_chance               = player->composite_spell_crit_chance();
-  }
-  else
-    assert( _spell_crit_chance == player->composite_spell_crit_chance() );
-  return _spell_crit_chance;
+  return get( CACHE_SPELL_CRIT_CHANCE, [ this ] { return player->composite_spell_crit_chance(); } );
 }
 
 double player_stat_cache_t::rppm_haste_coeff() const
 {
-  if ( !active || !valid[ CACHE_RPPM_HASTE ] )
-  {
-    valid[ CACHE_RPPM_HASTE ] = true;
-    _rppm_haste_coeff          = 1.0 / std::min( player->cache.spell_haste(), player->cache.attack_haste() );
-  }
-  else
-  {
-    assert( _rppm_haste_coeff == 1.0 / std::min( player->cache.spell_haste(), player->cache.attack_haste() ) );
-  }
-  return _rppm_haste_coeff;
+  return get( CACHE_RPPM_HASTE, [ this ] {
+    return 1.0 / std::min( player->cache.spell_haste(), player->cache.attack_haste() );
+  } );
 }
 
 double player_stat_cache_t::rppm_crit_coeff() const
 {
-  if ( !active || !valid[ CACHE_RPPM_CRIT ] )
-  {
-    valid[ CACHE_RPPM_CRIT ] = true;
-    _rppm_crit_coeff          = 1.0 + std::max( player->cache.attack_crit_chance(), player->cache.spell_crit_chance() );
-  }
-  else
-  {
-    assert( _rppm_crit_coeff == 1.0 + std::max( player->cache.attack_crit_chance(), player->cache.spell_crit_chance() ) );
-  }
-  return _rppm_crit_coeff;
+  return get( CACHE_RPPM_CRIT, [ this ] {
+    return 1.0 + std::max( player->cache.attack_crit_chance(), player->cache.spell_crit_chance() );
+  } );
 }
 
 double player_stat_cache_t::spell_haste() const
 {
-  if ( !active || !valid[ CACHE_SPELL_HASTE ] )
-  {
-    valid[ CACHE_SPELL_HASTE ] = true;
-    _spell_haste               = player->composite_spell_haste();
-  }
-  else
-    assert( _spell_haste == player->composite_spell_haste() );
-  return _spell_haste;
+  return get( CACHE_SPELL_HASTE, [ this ] { return player->composite_spell_haste(); } );
 }
 
 double player_stat_cache_t::spell_speed() const
 {
-  if ( !active || !valid[ CACHE_SPELL_SPEED ] )
-  {
-    valid[ CACHE_SPELL_SPEED ] = true;
-    _spell_speed               = player->composite_spell_speed();
-  }
-  else
-    assert( _spell_speed == player->composite_spell_speed() );
-  return _spell_speed;
+  return get( CACHE_SPELL_SPEED, [ this ] { return player->composite_spell_speed(); } );
 }
 
 double player_stat_cache_t::dodge() const
 {
-  if ( !active || !valid[ CACHE_DODGE ] )
-  {
-    valid[ CACHE_DODGE ] = true;
-    _dodge               = player->composite_dodge();
-  }
-  else
-    assert( _dodge == player->composite_dodge() );
-  return _dodge;
+  return get( CACHE_DODGE, [ this ] { return player->composite_dodge(); } );
 }
 
 double player_stat_cache_t::parry() const
 {
-  if ( !active || !valid[ CACHE_PARRY ] )
-  {
-    valid[ CACHE_PARRY ] = true;
-    _parry               = player->composite_parry();
-  }
-  else
-    assert( _parry == player->composite_parry() );
-  return _parry;
+  return get( CACHE_PARRY, [ this ] { return player->composite_parry(); } );
 }
 
 double player_stat_cache_t::block() const
 {
-  if ( !active || !valid[ CACHE_BLOCK ] )
-  {
-    valid[ CACHE_BLOCK ] = true;
-    _block               = player->composite_block();
-  }
-  else
-    assert( _block == player->composite_block() );
-  return _block;
+  return get( CACHE_BLOCK, [ this ] { return player->composite_block(); } );
 }
 
 double player_stat_cache_t::crit_block() const
 {
-  if ( !active || !valid[ CACHE_CRIT_BLOCK ] )
-  {
-    valid[ CACHE_CRIT_BLOCK ] = true;
-    _crit_block               = player->composite_crit_block();
-  }
-  else
-    assert( _crit_block == player->composite_crit_block() );
-  return _crit_block;
+  return get( CACHE_CRIT_BLOCK, [ this ] { return player->composite_crit_block(); } );
 }
 
 double player_stat_cache_t::crit_avoidance() const
 {
-  if ( !active || !valid[ CACHE_CRIT_AVOIDANCE ] )
-  {
-    valid[ CACHE_CRIT_AVOIDANCE ] = true;
-    _crit_avoidance               = player->composite_crit_avoidance();
-  }
-  else
-    assert( _crit_avoidance == player->composite_crit_avoidance() );
-  return _crit_avoidance;
+  return get( CACHE_CRIT_AVOIDANCE, [ this ] { return player->composite_crit_avoidance(); } );
 }
 
 double player_stat_cache_t::miss() const
 {
-  if ( !active || !valid[ CACHE_MISS ] )
-  {
-    valid[ CACHE_MISS ] = true;
-    _miss               = player->composite_miss();
-  }
-  else
-    assert( _miss == player->composite_miss() );
-  return _miss;
+  return get( CACHE_MISS, [ this ] { return player->composite_miss(); } );
 }
 
 double player_stat_cache_t::armor() const
 {
-  if ( !active || !valid[ CACHE_ARMOR ] || !valid[ CACHE_BONUS_ARMOR ] )
-  {
-    valid[ CACHE_ARMOR ] = true;
-    _armor               = player->composite_armor();
-  }
-  else
-    assert( _armor == player->composite_armor() );
-  return _armor;
+  return get( CACHE_ARMOR, [ this ] { return player->composite_armor(); } );
 }
 
 double player_stat_cache_t::mastery() const
 {
-  if ( !active || !valid[ CACHE_MASTERY ] )
-  {
-    valid[ CACHE_MASTERY ] = true;
-    _mastery               = player->composite_mastery();
-    _mastery_value         = player->composite_mastery_value();
-  }
-  else
-    assert( _mastery == player->composite_mastery() );
-  return _mastery;
+  return get( CACHE_MASTERY, [ this ] {
+    _mastery_value = player->composite_mastery_value();
+    return player->composite_mastery();
+  } );
 }
 
 /**
@@ -12305,284 +12188,408 @@ double player_stat_cache_t::mastery() const
  */
 double player_stat_cache_t::mastery_value() const
 {
-  if ( !active || !valid[ CACHE_MASTERY ] )
-  {
-    valid[ CACHE_MASTERY ] = true;
-    _mastery               = player->composite_mastery();
-    _mastery_value         = player->composite_mastery_value();
-  }
-  else
-    assert( _mastery_value == player->composite_mastery_value() );
+  if ( !active )
+    return player->composite_mastery_value();
+
+  mastery();
+  assert( _mastery_value == player->composite_mastery_value() );
   return _mastery_value;
 }
 
 double player_stat_cache_t::bonus_armor() const
 {
-  if ( !active || !valid[ CACHE_BONUS_ARMOR ] )
-  {
-    valid[ CACHE_BONUS_ARMOR ] = true;
-    _bonus_armor               = player->composite_bonus_armor();
-  }
-  else
-    assert( _bonus_armor == player->composite_bonus_armor() );
-  return _bonus_armor;
+  return get( CACHE_BONUS_ARMOR, [ this ] { return player->composite_bonus_armor(); } );
 }
 
 double player_stat_cache_t::damage_versatility() const
 {
-  if ( !active || !valid[ CACHE_DAMAGE_VERSATILITY ] )
-  {
-    valid[ CACHE_DAMAGE_VERSATILITY ] = true;
-    _damage_versatility               = player->composite_damage_versatility();
-  }
-  else
-    assert( _damage_versatility == player->composite_damage_versatility() );
-  return _damage_versatility;
+  return get( CACHE_DAMAGE_VERSATILITY, [ this ] { return player->composite_damage_versatility(); } );
 }
 
 double player_stat_cache_t::heal_versatility() const
 {
-  if ( !active || !valid[ CACHE_HEAL_VERSATILITY ] )
-  {
-    valid[ CACHE_HEAL_VERSATILITY ] = true;
-    _heal_versatility               = player->composite_heal_versatility();
-  }
-  else
-    assert( _heal_versatility == player->composite_heal_versatility() );
-  return _heal_versatility;
+  return get( CACHE_HEAL_VERSATILITY, [ this ] { return player->composite_heal_versatility(); } );
 }
 
 double player_stat_cache_t::mitigation_versatility() const
 {
-  if ( !active || !valid[ CACHE_MITIGATION_VERSATILITY ] )
-  {
-    valid[ CACHE_MITIGATION_VERSATILITY ] = true;
-    _mitigation_versatility               = player->composite_mitigation_versatility();
-  }
-  else
-    assert( _mitigation_versatility == player->composite_mitigation_versatility() );
-  return _mitigation_versatility;
+  return get( CACHE_MITIGATION_VERSATILITY, [ this ] { return player->composite_mitigation_versatility(); } );
 }
 
 double player_stat_cache_t::leech() const
 {
-  if ( !active || !valid[ CACHE_LEECH ] )
-  {
-    valid[ CACHE_LEECH ] = true;
-    _leech               = player->composite_leech();
-  }
-  else
-    assert( _leech == player->composite_leech() );
-  return _leech;
+  return get( CACHE_LEECH, [ this ] { return player->composite_leech(); } );
 }
 
 double player_stat_cache_t::run_speed() const
 {
-  if ( !active || !valid[ CACHE_RUN_SPEED ] )
-  {
-    valid[ CACHE_RUN_SPEED ] = true;
-    _run_speed               = player->composite_movement_speed();
-  }
-  else
-    assert( _run_speed == player->composite_movement_speed() );
-  return _run_speed;
+  return get( CACHE_RUN_SPEED, [ this ] { return player->composite_movement_speed(); } );
 }
 
 double player_stat_cache_t::avoidance() const
 {
-  if ( !active || !valid[ CACHE_AVOIDANCE ] )
-  {
-    valid[ CACHE_AVOIDANCE ] = true;
-    _avoidance               = player->composite_avoidance();
-  }
-  else
-    assert( _avoidance == player->composite_avoidance() );
-  return _avoidance;
+  return get( CACHE_AVOIDANCE, [ this ] { return player->composite_avoidance(); } );
 }
 
 double player_stat_cache_t::corruption() const
 {
-  if ( !active || !valid[ CACHE_CORRUPTION ] )
-  {
-    valid[ CACHE_CORRUPTION ] = true;
-    _corruption               = player->composite_corruption();
-  }
-  else
-    assert( _corruption == player->composite_corruption() );
-  return _corruption;
+  return get( CACHE_CORRUPTION, [ this ] { return player->composite_corruption(); } );
 }
 
 double player_stat_cache_t::corruption_resistance() const
 {
-  if ( !active || !valid[ CACHE_CORRUPTION_RESISTANCE ] )
-  {
-    valid[ CACHE_CORRUPTION_RESISTANCE ] = true;
-    _corruption_resistance               = player->composite_corruption_resistance();
-  }
-  else
-    assert( _corruption_resistance == player->composite_corruption_resistance() );
-  return _corruption_resistance;
+  return get( CACHE_CORRUPTION_RESISTANCE, [ this ] { return player->composite_corruption_resistance(); } );
 }
 
 double player_stat_cache_t::player_multiplier( school_e s ) const
 {
-  if ( !active || !player_mult_valid[ s ] )
+  return get_school( CACHE_PLAYER_DAMAGE_MULTIPLIER, player_mult_valid, _player_mult, s,
+                     [ this, s ] { return player->composite_player_multiplier( s ); } );
+}
+
+double player_stat_cache_t::player_heal_multiplier( const action_state_t* s ) const
+{
+  return get_school( CACHE_PLAYER_HEAL_MULTIPLIER, player_heal_mult_valid, _player_heal_mult,
+                     s->action->get_school(), [ this, s ] { return player->composite_player_heal_multiplier( s ); } );
+}
+
+#endif
+
+player_collected_data_t::action_sequence_data_t::action_sequence_data_t() :
+  action( nullptr ),
+  target( nullptr ),
+  time( timespan_t::zero() ),
+  wait_time( timespan_t::zero() )
+{
+  range::fill( resource_snapshot, -1 );
+  range::fill( resource_max_snapshot, -1 );
+}
+
+namespace
+{
+// Entry flags of the packed action sequence
+enum action_sequence_flags_e
+{
+  SEQUENCE_ACTION      = 0x1,
+  SEQUENCE_FULL_STATES = 0x2,
+};
+
+static_assert( RESOURCE_MAX <= 64, "Resource change masks of the action sequence are 64 bits wide" );
+
+bool sequence_buff( const buff_t* b )
+{
+  return b->check() && !b->quiet && !b->constant;
+}
+
+uint64_t zigzag( int64_t value )
+{
+  return ( static_cast<uint64_t>( value ) << 1 ) ^ static_cast<uint64_t>( value >> 63 );
+}
+
+// Sequential reader of the packed action sequence
+struct sequence_reader_t
+{
+  const std::vector<uint8_t>& data;
+  size_t pos;
+
+  sequence_reader_t( const std::vector<uint8_t>& d ) : data( d ), pos( 0 )
+  { }
+
+  uint64_t get()
+  {
+    uint64_t value = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+    do
+    {
+      assert( pos < data.size() );
+      byte = data[ pos++ ];
+      value |= static_cast<uint64_t>( byte & 0x7f ) << shift;
+      shift += 7;
+    } while ( byte & 0x80 );
+
+    return value;
+  }
+
+  timespan_t get_time()
   {
-    player_mult_valid[ s ] = true;
-    _player_mult[ s ]      = player->composite_player_multiplier( s );
+    uint64_t value = get();
+    return timespan_t::from_native( static_cast<int64_t>( value >> 1 ) ^ -static_cast<int64_t>( value & 1 ) );
   }
-  else
-    assert( _player_mult[ s ] == player->composite_player_multiplier( s ) );
-  return _player_mult[ s ];
+
+  double get_double()
+  {
+    double value;
+    std::memcpy( &value, &data[ pos ], sizeof( value ) );
+    pos += sizeof( value );
+    return value;
+  }
+
+  int64_t get_fixed()
+  {
+    int64_t value;
+    std::memcpy( &value, &data[ pos ], sizeof( value ) );
+    pos += sizeof( value );
+    return value;
+  }
+};
+} // unnamed namespace
+
+template <typename T>
+unsigned player_collected_data_t::action_sequence_t::intern_table_t<T>::get( T* value )
+{
+  auto it = index.find( value );
+  if ( it != index.end() )
+  {
+    return it->second;
+  }
+
+  auto idx = as<unsigned>( values.size() );
+  values.push_back( value );
+  index[ value ] = idx;
+  return idx;
 }
 
-double player_stat_cache_t::player_heal_multiplier( const action_state_t* s ) const
+player_collected_data_t::action_sequence_t::action_sequence_t()
 {
-  school_e sch = s->action->get_school();
+  clear();
+}
 
-  if ( !active || !player_heal_mult_valid[ sch ] )
+void player_collected_data_t::action_sequence_t::put( uint64_t value )
+{
+  while ( value >= 0x80 )
   {
-    player_heal_mult_valid[ sch ] = true;
-    _player_heal_mult[ sch ]      = player->composite_player_heal_multiplier( s );
+    data.push_back( static_cast<uint8_t>( value | 0x80 ) );
+    value >>= 7;
   }
-  else
-    assert( _player_heal_mult[ sch ] == player->composite_player_heal_multiplier( s ) );
-  return _player_heal_mult[ sch ];
+  data.push_back( static_cast<uint8_t>( value ) );
 }
 
-#endif
+void player_collected_data_t::action_sequence_t::put_time( timespan_t value )
+{
+  put( zigzag( timespan_t::to_native( value ) ) );
+}
 
-player_collected_data_t::action_sequence_data_t::action_sequence_data_t( const action_t* a, const player_t* t,
-                                                                         const timespan_t& ts, const player_t* p ) :
-  action( a ),
-  target( t ),
-  time( ts ),
-  wait_time( timespan_t::zero() )
+void player_collected_data_t::action_sequence_t::put_double( double value )
 {
-  for ( size_t i = 0; i < p->buff_list.size(); ++i )
+  uint8_t bytes[ sizeof( value ) ];
+  std::memcpy( bytes, &value, sizeof( value ) );
+  data.insert( data.end(), bytes, bytes + sizeof( value ) );
+}
+
+void player_collected_data_t::action_sequence_t::add_entry( const action_t* a, const player_t* t, timespan_t ts,
+                                                            timespan_t wait, const player_t* p )
+{
+  bool full_states = p->sim->json_full_states != 0;
+
+  put( ( a ? SEQUENCE_ACTION : 0 ) | ( full_states ? SEQUENCE_FULL_STATES : 0 ) );
+  put_time( ts - last_time );
+  last_time = ts;
+
+  if ( a )
+  {
+    put( actions.get( a ) );
+    put( actors.get( t ) );
+    last_wait_offset = std::string::npos;
+  }
+  else
+  {
+    // Fixed width, so following waits can be merged in place
+    last_wait_offset = data.size();
+    int64_t native = timespan_t::to_native( wait );
+    uint8_t bytes[ sizeof( native ) ];
+    std::memcpy( bytes, &native, sizeof( native ) );
+    data.insert( data.end(), bytes, bytes + sizeof( native ) );
+  }
+
+  put( range::count_if( p->buff_list, sequence_buff ) );
+  for ( buff_t* b : p->buff_list )
   {
-    buff_t* b = p->buff_list[ i ];
-    if ( b->check() && !b->quiet && !b->constant )
+    if ( sequence_buff( b ) )
     {
-      std::vector<double> buff_args;
-      buff_args.push_back( b->check() );
-      if ( p->sim->json_full_states )
+      put( buffs.get( b ) );
+      put( b->check() );
+      if ( full_states )
       {
-        buff_args.push_back( b->remains().total_seconds() );
+        put_time( b->remains() );
       }
-      buff_list.emplace_back( b, buff_args );
     }
   }
 
   // Adding cooldown and debuffs snapshots if asking for json full states
-  if ( p->sim->json_full_states )
+  if ( full_states )
   {
-    for ( size_t i = 0; i < p->cooldown_list.size(); ++i )
+    put( range::count_if( p->cooldown_list, []( const cooldown_t* c ) { return c->down(); } ) );
+    for ( cooldown_t* c : p->cooldown_list )
     {
-      cooldown_t* c = p->cooldown_list[ i ];
       if ( c->down() )
       {
-        std::vector<double> cooldown_args;
-        cooldown_args.push_back( c->charges );
-        cooldown_args.push_back( c->remains().total_seconds() );
-        cooldown_list.emplace_back( c, cooldown_args );
+        put( cooldowns.get( c ) );
+        put( c->charges );
+        put_time( c->remains() );
       }
     }
-    for ( player_t* current_target : p->sim->target_list )
+
+    put( p->sim->target_list.size() );
+    for ( const player_t* current_target : p->sim->target_list )
     {
-      std::vector<std::pair<buff_t*, std::vector<double> > > debuff_list;
-      for ( size_t i = 0; i < current_target->buff_list.size(); ++i )
+      put( actors.get( current_target ) );
+      put( range::count_if( current_target->buff_list, sequence_buff ) );
+      for ( buff_t* d : current_target->buff_list )
       {
-        buff_t* d = current_target->buff_list[ i ];
-        if ( d->check() && !d->quiet && !d->constant )
+        if ( sequence_buff( d ) )
         {
-          std::vector<double> debuff_args;
-          debuff_args.push_back( d->check() );
-          debuff_args.push_back( d->remains().total_seconds() );
-          debuff_list.emplace_back( d, debuff_args );
+          put( buffs.get( d ) );
+          put( d->check() );
+          put_time( d->remains() );
         }
       }
-      target_list.emplace_back( current_target, debuff_list );
     }
   }
 
-  range::fill( resource_snapshot, -1 );
-  range::fill( resource_max_snapshot, -1 );
+  uint64_t changed = 0, changed_max = 0;
+  std::array<double, RESOURCE_MAX> resource, resource_max;
+  for ( resource_e i = RESOURCE_HEALTH; i < RESOURCE_MAX; ++i )
+  {
+    bool active = p->resources.max[ i ] > 0.0;
+    resource[ i ] = active ? p->resources.current[ i ] : -1;
+    resource_max[ i ] = active ? p->resources.max[ i ] : -1;
 
+    if ( resource[ i ] != last_resource[ i ] )
+      changed |= uint64_t( 1 ) << i;
+    if ( resource_max[ i ] != last_resource_max[ i ] )
+      changed_max |= uint64_t( 1 ) << i;
+  }
+
+  put( changed );
+  put( changed_max );
   for ( resource_e i = RESOURCE_HEALTH; i < RESOURCE_MAX; ++i )
   {
-    if ( p->resources.max[ i ] > 0.0 )
+    if ( changed & ( uint64_t( 1 ) << i ) )
+      put_double( resource[ i ] );
+    if ( changed_max & ( uint64_t( 1 ) << i ) )
+      put_double( resource_max[ i ] );
+  }
+  last_resource = resource;
+  last_resource_max = resource_max;
+
+  ++n_entries;
+}
+
+void player_collected_data_t::action_sequence_t::add( const action_t* a, const player_t* target, timespan_t ts,
+                                                      const player_t* p )
+{
+  add_entry( a, target, ts, timespan_t::zero(), p );
+}
+
+void player_collected_data_t::action_sequence_t::add_wait( timespan_t ts, timespan_t wait, const player_t* p )
+{
+  if ( last_wait_offset != std::string::npos )
+  {
+    int64_t native;
+    std::memcpy( &native, &data[ last_wait_offset ], sizeof( native ) );
+    if ( native > 0 )
     {
-      resource_snapshot[ i ]     = p->resources.current[ i ];
-      resource_max_snapshot[ i ] = p->resources.max[ i ];
+      native += timespan_t::to_native( wait );
+      std::memcpy( &data[ last_wait_offset ], &native, sizeof( native ) );
+      return;
     }
   }
+
+  add_entry( nullptr, nullptr, ts, wait, p );
 }
 
-player_collected_data_t::action_sequence_data_t::action_sequence_data_t( const timespan_t& ts, const timespan_t& wait,
-                                                                         const player_t* p ) :
-  action( nullptr ),
-  target( nullptr ),
-  time( ts ),
-  wait_time( wait )
+void player_collected_data_t::action_sequence_t::reserve( size_t entries )
 {
-  for ( size_t i = 0; i < p->buff_list.size(); ++i )
-  {
-    buff_t* b = p->buff_list[ i ];
-    if ( b->check() && !b->quiet && !b->constant )
+  // Roughly the size of an entry with a handful of active buffs and one changed resource
+  data.reserve( entries * 32 );
+}
+
+void player_collected_data_t::action_sequence_t::clear()
+{
+  data.clear();
+  n_entries = 0;
+  last_wait_offset = std::string::npos;
+  last_time = timespan_t::zero();
+  range::fill( last_resource, -1 );
+  range::fill( last_resource_max, -1 );
+}
+
+void player_collected_data_t::action_sequence_t::for_each(
+    const std::function<void( const action_sequence_data_t& )>& fn ) const
+{
+  sequence_reader_t reader( data );
+  action_sequence_data_t entry;
+
+  auto read_buffs = [ this, &reader ]( std::vector<std::pair<buff_t*, std::vector<double>>>& list, bool remains ) {
+    list.resize( reader.get() );
+    for ( auto& buff : list )
     {
-      std::vector<double> buff_args;
-      buff_args.push_back( b->check() );
-      if ( p->sim->json_full_states )
+      buff.first = buffs.values[ reader.get() ];
+      buff.second.clear();
+      buff.second.push_back( static_cast<double>( reader.get() ) );
+      if ( remains )
       {
-        buff_args.push_back( b->remains().total_seconds() );
+        buff.second.push_back( reader.get_time().total_seconds() );
       }
-      buff_list.emplace_back( b, buff_args );
     }
-  }
+  };
 
-  // Adding cooldown and debuffs snapshots if asking for json full states
-  if ( p->sim->json_full_states )
+  for ( size_t n = 0; n < n_entries; ++n )
   {
-    for ( size_t i = 0; i < p->cooldown_list.size(); ++i )
+    auto flags = reader.get();
+    bool full_states = ( flags & SEQUENCE_FULL_STATES ) != 0;
+
+    entry.time += reader.get_time();
+    if ( flags & SEQUENCE_ACTION )
     {
-      cooldown_t* c = p->cooldown_list[ i ];
-      if ( c->down() )
-      {
-        std::vector<double> cooldown_args;
-        cooldown_args.push_back( c->charges );
-        cooldown_args.push_back( c->remains().total_seconds() );
-        cooldown_list.emplace_back( c, cooldown_args );
-      }
+      entry.action = actions.values[ reader.get() ];
+      entry.target = actors.values[ reader.get() ];
+      entry.wait_time = timespan_t::zero();
     }
-    for ( player_t* current_target : p->sim->target_list )
+    else
     {
-      std::vector<std::pair<buff_t*, std::vector<double> > > debuff_list;
-      for ( size_t i = 0; i < current_target->buff_list.size(); ++i )
+      entry.action = nullptr;
+      entry.target = nullptr;
+      entry.wait_time = timespan_t::from_native( reader.get_fixed() );
+    }
+
+    read_buffs( entry.buff_list, full_states );
+
+    if ( full_states )
+    {
+      entry.cooldown_list.resize( reader.get() );
+      for ( auto& cooldown : entry.cooldown_list )
       {
-        buff_t* d = current_target->buff_list[ i ];
-        if ( d->check() && !d->quiet && !d->constant )
-        {
-          std::vector<double> debuff_args;
-          debuff_args.push_back( d->check() );
-          debuff_args.push_back( d->remains().total_seconds() );
-          debuff_list.emplace_back( d, debuff_args );
-        }
+        cooldown.first = cooldowns.values[ reader.get() ];
+        auto charges = static_cast<double>( reader.get() );
+        cooldown.second.assign( { charges, reader.get_time().total_seconds() } );
       }
-      target_list.emplace_back( current_target, debuff_list );
-    }
-  }
 
-  range::fill( resource_snapshot, -1 );
-  range::fill( resource_max_snapshot, -1 );
+      entry.target_list.resize( reader.get() );
+      for ( auto& target : entry.target_list )
+      {
+        target.first = actors.values[ reader.get() ];
+        read_buffs( target.second, true );
+      }
+    }
+    else
+    {
+      entry.cooldown_list.clear();
+      entry.target_list.clear();
+    }
 
-  for ( resource_e i = RESOURCE_HEALTH; i < RESOURCE_MAX; ++i )
-  {
-    if ( p->resources.max[ i ] > 0.0 )
+    uint64_t changed = reader.get();
+    uint64_t changed_max = reader.get();
+    for ( resource_e i = RESOURCE_HEALTH; i < RESOURCE_MAX; ++i )
     {
-      resource_snapshot[ i ]     = p->resources.current[ i ];
-      resource_max_snapshot[ i ] = p->resources.max[ i ];
+      if ( changed & ( uint64_t( 1 ) << i ) )
+        entry.resource_snapshot[ i ] = reader.get_double();
+      if ( changed_max & ( uint64_t( 1 ) << i ) )
+        entry.resource_max_snapshot[ i ] = reader.get_double();
     }
+
+    fn( entry );
   }
 }
 
@@ -12666,6 +12673,18 @@ player_collected_data_t::player_collected_data_t( const player_t* player ) :
 
 void player_collected_data_t::reserve_memory( const player_t& p )
 {
+  // Fight length keeps every sample, timelines are adjusted by its exact distribution
+  if ( p.sim->sample_data_sketch > 0 )
+  {
+    for ( auto sd : { &waiting_time, &pooling_time, &executed_foreground_actions, &dmg, &compound_dmg,
+                      &prioritydps, &dps, &dpse, &dtps, &dmg_taken, &heal, &compound_heal, &hps, &hpse, &htps,
+                      &heal_taken, &absorb, &compound_absorb, &aps, &atps, &absorb_taken, &deaths,
+                      &theck_meloree_index, &effective_theck_meloree_index, &max_spike_amount, &target_metric } )
+    {
+      sd->enable_sketch( p.sim->sample_data_sketch );
+    }
+  }
+
   unsigned size = std::min( as<unsigned>( p.sim->iterations ), 2048u );
   fight_length.reserve( size );
   // DMG
@@ -12690,6 +12709,26 @@ void player_collected_data_t::reserve_memory( const player_t& p )
     effective_theck_meloree_index.reserve( size );
     p.sim->num_tanks++;
   }
+
+  auto& arena = p.sim->timeline_arena;
+  timeline_dmg_taken.attach( arena );
+  timeline_healing_taken.attach( arena );
+
+  for ( auto& tl : stat_timelines )
+  {
+    tl.timeline.set_bin_size( p.sim->timeline_bin_size );
+    tl.timeline.attach( arena );
+  }
+
+  for ( auto hc : { &health_changes, &health_changes_tmi } )
+  {
+    if ( hc->collect )
+    {
+      hc->timeline.attach( arena );
+      hc->timeline_normalized.attach( arena );
+      hc->merged_timeline.attach( arena );
+    }
+  }
 }
 
 void player_collected_data_t::merge( const player_t& other_player )
@@ -12855,7 +12894,7 @@ double player_collected_data_t::calculate_max_spike_damage( const health_changes
   tl.timeline_normalized.build_sliding_average_timeline( sliding_average_tl, window );
 
   // pull the data out of the normalized sliding average timeline
-  std::vector<double> weighted_value = sliding_average_tl.data();
+  auto weighted_value = sliding_average_tl.data();
 
   // extract the max spike size from the sliding average timeline
   max_spike = *std::max_element( weighted_value.begin(), weighted_value.end() );  // todo: remove weighted_value here
@@ -12882,7 +12921,7 @@ double player_collected_data_t::calculate_tmi( const health_changes_timeline_t&
   tl.timeline_normalized.build_sliding_average_timeline( sliding_average_tl, window );
 
   // pull the data out of the normalized sliding average timeline
-  std::vector<double> weighted_value = sliding_average_tl.data();
+  std::vector<double> weighted_value = sliding_average_tl.data().to_vector();
 
   // define constants
   double D  = 10;          // filtering strength
@@ -4126,10 +4126,18 @@ void unique_gear::init( player_t* p )
 {
   if ( p -> is_pet() || p -> is_enemy() ) return;
 
+  // Per item and generic effect timing, part of the init_special_effects phase of the actor
+  init_profile_t::timer_t timer( p -> sim -> init_profile, p );
+
   for ( size_t i = 0; i < p -> items.size(); i++ )
   {
     item_t& item = p -> items[ i ];
 
+    if ( ! item.parsed.special_effects.empty() && p -> sim -> init_profile.enabled )
+    {
+      timer.next( "init_special_effects/" + item.name_str );
+    }
+
     for ( size_t j = 0; j < item.parsed.special_effects.size(); j++ )
     {
       special_effect_t* effect = item.parsed.special_effects[ j ];
@@ -4147,6 +4155,11 @@ void unique_gear::init( player_t* p )
     if ( p -> sim -> debug )
       p -> sim -> out_debug.printf( "Initializing generic special effect %s", effect -> to_string().c_str() );
 
+    if ( p -> sim -> init_profile.enabled )
+    {
+      timer.next( "init_special_effects/" + effect -> name() );
+    }
+
     initialize_special_effect_2( effect );
   }
 }
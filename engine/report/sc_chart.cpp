@@ -1609,6 +1609,10 @@ highchart::time_series_t& chart::generate_actor_timeline(
   ts.set_title( util::encode_html( p.name_str ) + " " + attr_str );
   ts.set_yaxis_title( "Average " + attr_str );
   ts.add_simple_series( "area", series_color, attr_str, data.data() );
+  if ( data.get_bin_size() != 1.0 )
+  {
+    ts.set( "plotOptions.series.pointInterval", data.get_bin_size() );
+  }
   if ( !p.sim->single_actor_batch )
   {
     ts.set_xaxis_max( p.sim->simulation_length.max() );
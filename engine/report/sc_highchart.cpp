@@ -388,6 +388,14 @@ void chart_t::add_simple_series( const std::string& type,
   add( "series", obj );
 }
 
+void chart_t::add_simple_series( const std::string& type,
+                                 const std::string& color,
+                                 const std::string& name,
+                                 arv::array_view<double> series )
+{
+  add_simple_series( type, color, name, std::vector<double>( series.begin(), series.end() ) );
+}
+
 /**
  * Add y-axis plotline to the chart at value_ height. If name is given, a
  * subtitle will be added to the chart, stating name_=value_. Both the line and
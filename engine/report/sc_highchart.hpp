@@ -73,6 +73,9 @@ public:
   void add_simple_series( const std::string& type, const std::string& color,
                           const std::string& name,
                           const std::vector<double>& series );
+  void add_simple_series( const std::string& type, const std::string& color,
+                          const std::string& name,
+                          arv::array_view<double> series );
   void add_simple_series( const std::string& type, const std::string& color,
                           const std::string& name,
                           const std::vector<data_triple_t>& series );
@@ -820,6 +820,35 @@ void report::print_suite( sim_t* sim )
   report::print_html( *sim );
   report::print_json( *sim );
   report::print_profiles( sim );
+  report::print_cpu_profile( *sim );
+}
+
+// report::print_cpu_profile ================================================
+
+// Folded stacks of the cpu_profile sampler, one "frame;frame;frame microseconds" line per stack.
+// The file can be rendered with flamegraph.pl or loaded into speedscope directly.
+void report::print_cpu_profile( sim_t& sim )
+{
+  if ( sim.cpu_profile.output_file_str.empty() || sim.cpu_profile.folded.empty() )
+  {
+    return;
+  }
+
+  io::cfile file( sim.cpu_profile.output_file_str, "w" );
+  if ( !file )
+  {
+    sim.errorf( "Unable to open cpu profile output file '%s'.", sim.cpu_profile.output_file_str.c_str() );
+    return;
+  }
+
+  for ( const auto& stack : sim.cpu_profile.folded )
+  {
+    auto us = static_cast<unsigned long long>( stack.second * 1e6 + 0.5 );
+    if ( us > 0 )
+    {
+      fprintf( file, "%s %llu\n", stack.first.c_str(), us );
+    }
+  }
 }
 
 void report::print_html_sample_data( report::sc_html_stream& os, const player_t& p, const extended_sample_data_t& data,
@@ -863,6 +892,12 @@ void report::print_html_sample_data( report::sc_html_stream& os, const player_t&
     os.printf( "<tr>\n<td class=\"left\">( 95th Percentile - 5th Percentile )</td>\n"
                "<td class=\"right\">%.2f</td>\n</tr>\n",
                data.percentile( 0.95 ) - data.percentile( 0.05 ) );
+    if ( data.sketched() )
+    {
+      os.printf( "<tr>\n<td class=\"left\">Percentile Rank Error ( sketch )</td>\n"
+                 "<td class=\"right\">&lt;= %.2f%%</td>\n</tr>\n",
+                 data.rank_error_bound() * 100.0 );
+    }
 
     os << "<tr>\n"
        << "<th class=\"left\" colspan=\"2\">Mean Distribution</th>\n"
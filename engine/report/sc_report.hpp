@@ -15,9 +15,11 @@
 #include "sc_enums.hpp"
 #include "sc_highchart.hpp"
 #include "util/io.hpp"
+#include "util/concurrency.hpp"
 #include "sc_util.hpp"
 
 struct player_t;
+struct stats_t;
 struct action_t;
 struct buff_t;
 struct item_t;
@@ -26,6 +28,7 @@ struct sc_timeline_t;
 struct spell_data_t;
 class extended_sample_data_t;
 struct player_processed_report_information_t;
+struct init_profile_t;
 struct sim_report_information_t;
 struct spell_data_expr_t;
 struct artifact_power_t;
@@ -219,11 +222,109 @@ void print_spell_query( xml_node_t* out, FILE* file, const sim_t& sim, const spe
 bool check_gear( player_t& p, sim_t& sim );
 void print_profiles( sim_t* );
 void print_text( sim_t*, bool detail );
+void print_init_profile( std::ostream&, const init_profile_t&, const std::string& title );
+void print_cpu_profile( sim_t& );
 void print_html( sim_t& );
 void print_json( sim_t& );
 void print_html_player( report::sc_html_stream&, player_t& );
 void print_suite( sim_t* );
 std::vector<std::string> beta_warnings();
+
+/**
+ * Collects the chart data that report code adds to the sim while the collector is current for the
+ * thread, so report sections can be rendered concurrently and their chart data appended to the sim
+ * in report order.
+ */
+class chart_data_collector_t
+{
+public:
+  std::vector<std::string>                         on_ready_chart_data;
+  std::vector<std::pair<std::string, std::string>> chart_data;
+
+  // Collector of the current thread, or nullptr if chart data is added to the sim directly
+  static chart_data_collector_t* current();
+  static void set_current( chart_data_collector_t* collector );
+
+  void add( const highchart::chart_t& chart );
+  void merge( sim_t& sim ) const;
+};
+
+/**
+ * Binary columnar output of per-iteration data (iteration_data_file option), shared by the sim
+ * threads of a simulation. All values are 8 bytes wide and stored in little-endian byte order (byte
+ * swapped on big-endian hosts), so on little-endian hosts the file can be memory mapped.
+ *
+ * Header: 8 byte magic "SIMCITER", uint32 version, uint32 column count, then for each column a
+ * uint32 type (0 = uint64, 1 = double), a uint32 name length and the name, zero padded to a multiple
+ * of 8 bytes.
+ *
+ * Blocks: uint64 row count, followed by the values of each column for those rows, one column after
+ * another. Blocks follow each other until the end of the file.
+ */
+class iteration_data_file_t : private noncopyable
+{
+public:
+  enum column_type_e : uint32_t
+  {
+    COLUMN_UINT64 = 0,
+    COLUMN_DOUBLE = 1
+  };
+
+  struct column_t
+  {
+    std::string           name;
+    column_type_e         type;
+    // Doubles are stored with their bit pattern
+    std::vector<uint64_t> data;
+
+    column_t( const std::string& n, column_type_e t ) : name( n ), type( t )
+    { }
+  };
+
+private:
+  io::cfile                file;
+  std::vector<std::string> names;
+  std::string              error_str;
+  mutable mutex_t          mutex;
+
+  bool write_header( const std::vector<column_t>& columns );
+
+public:
+  explicit iteration_data_file_t( const std::string& path );
+
+  bool is_open() const
+  { return file != nullptr; }
+
+  // Write the buffered rows of the columns as one block, thread-safe. Errors are recorded instead of
+  // thrown, as blocks are written from the sim threads, and stop any further output.
+  void write_block( const std::vector<column_t>& columns );
+
+  // First error writing the file, empty if there was none
+  std::string error() const;
+};
+
+/**
+ * Per-sim buffer of iteration data, collected at the end of each iteration and written to the shared
+ * file in blocks of rows. Columns are the iteration index, the seed (identifies the iteration in
+ * deterministic sims), the sim thread, the fight length and raid dps, and per player the dps and
+ * the damage of each of its (and its pets') damage stats objects that exist after initialization.
+ */
+class iteration_data_output_t
+{
+  static const size_t BLOCK_ROWS = 4096;
+
+  std::shared_ptr<iteration_data_file_t>      file;
+  std::vector<iteration_data_file_t::column_t> columns;
+  // Column data sources, player dps columns have a null stats object
+  std::vector<std::pair<const player_t*, const stats_t*>> sources;
+  size_t                                     rows;
+
+public:
+  iteration_data_output_t( std::shared_ptr<iteration_data_file_t> file, const sim_t& sim );
+
+  void collect( const sim_t& sim );
+  void flush();
+};
 std::string pretty_spell_text( const spell_data_t& default_spell, const std::string& text, const player_t& p );
 inline std::string pretty_spell_text( const spell_data_t& default_spell, const char* text, const player_t& p )
 {
@@ -2399,10 +2399,9 @@ void print_html_player_action_priority_list( report::sc_html_stream& os, const p
       targets.emplace_back(p.target->name() );
     }
 
-    for ( const auto& sequence_data : p.collected_data.action_sequence )
-    {
+    p.collected_data.action_sequence.for_each( [ &targets ]( const player_collected_data_t::action_sequence_data_t& sequence_data ) {
       if ( !sequence_data.action || !sequence_data.action->harmful )
-        continue;
+        return;
       bool found = false;
       for ( size_t j = 0; j < targets.size(); ++j )
       {
@@ -2414,7 +2413,7 @@ void print_html_player_action_priority_list( report::sc_html_stream& os, const p
       }
       if ( !found )
         targets.emplace_back(sequence_data.target->name() );
-    }
+    } );
 
     // Sample Sequence (text string)
 
@@ -2439,15 +2438,13 @@ void print_html_player_action_priority_list( report::sc_html_stream& os, const p
 
     os << "</style>\n";
 
-    for ( const auto& sequence_data : p.collected_data.action_sequence_precombat )
-    {
+    p.collected_data.action_sequence_precombat.for_each( [ &os, &p ]( const player_collected_data_t::action_sequence_data_t& sequence_data ) {
       print_html_sample_sequence_string_entry( os, sequence_data, p, true );
-    }
+    } );
 
-    for ( const auto& sequence_data : p.collected_data.action_sequence )
-    {
+    p.collected_data.action_sequence.for_each( [ &os, &p ]( const player_collected_data_t::action_sequence_data_t& sequence_data ) {
       print_html_sample_sequence_string_entry( os, sequence_data, p );
-    }
+    } );
 
     os << "\n</div>\n"
        << "</div>\n";
@@ -2473,15 +2470,13 @@ void print_html_player_action_priority_list( report::sc_html_stream& os, const p
        << "</thead>\n";
 
     os << "<tbody>\n";
-    for ( const auto& sequence_data : p.collected_data.action_sequence_precombat )
-    {
+    p.collected_data.action_sequence_precombat.for_each( [ &os, &p ]( const player_collected_data_t::action_sequence_data_t& sequence_data ) {
       print_html_sample_sequence_table_entry( os, sequence_data, p, true );
-    }
+    } );
 
-    for ( const auto& sequence_data : p.collected_data.action_sequence )
-    {
+    p.collected_data.action_sequence.for_each( [ &os, &p ]( const player_collected_data_t::action_sequence_data_t& sequence_data ) {
       print_html_sample_sequence_table_entry( os, sequence_data, p );
-    }
+    } );
     os << "</tbody>\n";
 
     // close table
@@ -426,6 +426,12 @@ void print_html_sim_summary( report::sc_html_stream& os, sim_t& sim )
              "</tr>\n",
              as<long>( sim.event_mgr.max_events_remaining ) );
 
+  os.printf( "<tr class=\"left\">\n"
+             "<th>Event Memory:</th>\n"
+             "<td>%.1f KiB</td>\n"
+             "</tr>\n",
+             sim.event_mgr.event_memory() / 1024.0 );
+
   os.printf( "<tr class=\"left\">\n"
              "<th>Sim Seconds:</th>\n"
              "<td>%.0f</td>\n"
@@ -532,6 +538,64 @@ void print_html_sim_summary( report::sc_html_stream& os, sim_t& sim )
      << "</div>\n\n";
 }
 
+// print_html_cpu_profile ===================================================
+
+void print_html_cpu_profile( report::sc_html_stream& os, const sim_t& sim )
+{
+  const cpu_profile_t& profile = sim.cpu_profile;
+  if ( profile.entries.empty() || profile.profiled_time <= 0 )
+  {
+    return;
+  }
+
+  os << "<div class=\"section\">\n"
+     << "<h2 class=\"toggle\">CPU Profile: Hottest Actions</h2>\n"
+     << "<div class=\"toggle-content hide\">\n";
+
+  os.printf( "<p>Estimated from %llu sampled events (1 in %d), %.3f seconds of event processing in total. "
+             "Self time excludes the actions and events called from the entry.</p>\n",
+             static_cast<unsigned long long>( profile.sampled_events ), profile.sample_rate, profile.profiled_time );
+
+  os << "<table class=\"sc even\">\n"
+     << "<thead>\n"
+     << "<tr>\n"
+     << "<th class=\"left\">Actor</th>\n"
+     << "<th class=\"left\">Action / Event</th>\n"
+     << "<th class=\"left\">Phase</th>\n"
+     << "<th>Calls</th>\n"
+     << "<th>Self (s)</th>\n"
+     << "<th>Self %</th>\n"
+     << "<th>Total (s)</th>\n"
+     << "<th>Self per Call (ns)</th>\n"
+     << "</tr>\n"
+     << "</thead>\n";
+
+  const size_t max_rows = 50;
+  size_t rows = 0;
+  for ( const auto entry : profile.sorted() )
+  {
+    if ( rows++ == max_rows )
+    {
+      break;
+    }
+
+    os << "<tr>\n";
+    os << "<td class=\"left\">" << util::encode_html( entry -> actor ) << "</td>\n";
+    os << "<td class=\"left\">" << util::encode_html( entry -> name ) << "</td>\n";
+    os << "<td class=\"left\">" << cpu_profile_t::phase_string( entry -> phase ) << "</td>\n";
+    os.printf( "<td class=\"right\">%.0f</td>\n", entry -> count );
+    os.printf( "<td class=\"right\">%.4f</td>\n", entry -> self );
+    os.printf( "<td class=\"right\">%.2f%%</td>\n", 100.0 * entry -> self / profile.profiled_time );
+    os.printf( "<td class=\"right\">%.4f</td>\n", entry -> total );
+    os.printf( "<td class=\"right\">%.0f</td>\n", entry -> count > 0 ? 1e9 * entry -> self / entry -> count : 0.0 );
+    os << "</tr>\n";
+  }
+
+  os << "</table>\n";
+  os << "</div>\n";
+  os << "</div>\n\n";
+}
+
 // print_html_raid_summary ==================================================
 
 void print_html_raid_summary( report::sc_html_stream& os, sim_t& sim )
@@ -1300,10 +1364,177 @@ void print_nothing_to_report( report::sc_html_stream& os, const std::string& rea
      << "</div>\n\n";
 }
 
+/* Report section of an actor, followed by its separately reported pets, rendered into memory.
+ */
+struct html_section_t
+{
+  std::vector<player_t*>         players;
+  std::stringbuf                 buffer;
+  report::chart_data_collector_t charts;
+  std::string                    error_str;
+};
+
+void render_section( html_section_t& section, const sim_t& sim )
+{
+  report::chart_data_collector_t::set_current( &section.charts );
+
+  // Unopened file stream that writes into the section buffer instead, so the player report code
+  // can be used as is
+  report::sc_html_stream os;
+  static_cast<std::ostream&>( os ).rdbuf( &section.buffer );
+  os.precision( sim.report_precision );
+  os << std::fixed;
+
+  try
+  {
+    for ( auto player : section.players )
+    {
+      report::print_html_player( os, *player );
+    }
+  }
+  catch ( const std::exception& e )
+  {
+    section.error_str = e.what();
+  }
+
+  report::chart_data_collector_t::set_current( nullptr );
+}
+
+/* Renders report sections on a pool thread. Sections are claimed through a shared counter, so
+ * threads stay busy when some actors take much longer to report than others.
+ */
+class section_renderer_t : private sc_thread_t
+{
+  std::vector<html_section_t>& sections;
+  std::atomic<size_t>&         next;
+  const sim_t&                 sim;
+
+  void run() override
+  { execute(); }
+
+public:
+  section_renderer_t( std::vector<html_section_t>& s, std::atomic<size_t>& n, const sim_t& sim ) :
+    sections( s ), next( n ), sim( sim )
+  { }
+
+  using sc_thread_t::launch;
+  using sc_thread_t::join;
+
+  void execute()
+  {
+    for ( size_t i = next++; i < sections.size(); i = next++ )
+    {
+      render_section( sections[ i ], sim );
+    }
+  }
+};
+
+/* Render all report sections, using up to sim.threads threads. Returns the number of threads used.
+ */
+size_t render_sections( std::vector<html_section_t>& sections, const sim_t& sim )
+{
+  std::atomic<size_t> next( 0 );
+
+  size_t n_threads = std::min( sections.size(), as<size_t>( std::max( 1, sim.threads ) ) );
+
+  std::vector<std::unique_ptr<section_renderer_t>> renderers;
+  for ( size_t i = 1; i < n_threads; ++i )
+  {
+    renderers.push_back( std::make_unique<section_renderer_t>( sections, next, sim ) );
+    renderers.back() -> launch();
+  }
+
+  // The calling thread renders too
+  section_renderer_t( sections, next, sim ).execute();
+
+  range::for_each( renderers, []( std::unique_ptr<section_renderer_t>& r ) { r -> join(); } );
+
+  return n_threads;
+}
+
+/* Write rendered sections to the report, and add their chart data to the sim in report order
+ */
+void write_sections( report::sc_html_stream& os, sim_t& sim, std::vector<html_section_t>& sections,
+                     size_t first, size_t last )
+{
+  for ( size_t i = first; i < last; ++i )
+  {
+    auto& section = sections[ i ];
+    if ( ! section.error_str.empty() )
+    {
+      throw std::runtime_error( section.error_str );
+    }
+
+    os << section.buffer.str();
+    section.charts.merge( sim );
+
+    section.buffer.str( std::string() );
+    section.charts = report::chart_data_collector_t();
+  }
+}
+
+/* Wall time spent in the phases of html report generation
+ */
+struct html_timings_t
+{
+  size_t sections = 0;
+  size_t threads = 0;
+  double render = 0;
+  double head = 0;
+  double body = 0;
+  double scripts = 0;
+};
+
 /* Main function building the html document and calling subfunctions
  */
-void print_html_( report::sc_html_stream& os, sim_t& sim )
+void print_html_( report::sc_html_stream& os, sim_t& sim, html_timings_t& timings )
 {
+  // Players and targets are rendered up front in parallel, one section per actor and its pets, and
+  // written in order once the report reaches them
+  auto start = util::wall_time();
+
+  std::vector<html_section_t> sections( sim.players_by_name.size() +
+                                        ( sim.report_targets ? sim.targets_by_name.size() : 0 ) );
+  size_t n_player_sections = sim.players_by_name.size();
+
+  for ( size_t i = 0; i < n_player_sections; ++i )
+  {
+    auto player = sim.players_by_name[ i ];
+    sections[ i ].players.push_back( player );
+
+    // Pets
+    if ( sim.report_pets_separately )
+    {
+      for ( auto& pet : player->pet_list )
+      {
+        if ( pet->summoned && !pet->quiet )
+          sections[ i ].players.push_back( pet );
+      }
+    }
+  }
+
+  for ( size_t i = n_player_sections; i < sections.size(); ++i )
+  {
+    auto player = sim.targets_by_name[ i - n_player_sections ];
+    sections[ i ].players.push_back( player );
+
+    // Pets
+    if ( sim.report_pets_separately )
+    {
+      for ( auto& pet : player->pet_list )
+      {
+        // if ( pet -> summoned )
+        sections[ i ].players.push_back( pet );
+      }
+    }
+  }
+
+  timings.sections = sections.size();
+  timings.threads = render_sections( sections, sim );
+  timings.render = util::wall_time() - start;
+
+  start = util::wall_time();
+
   // Set floating point formatting
   os.precision( sim.report_precision );
   os << std::fixed;
@@ -1353,46 +1584,23 @@ void print_html_( report::sc_html_stream& os, sim_t& sim )
 
   sim.profilesets.output_html( sim, os );
 
-  // Report Players
-  for ( auto& player : sim.players_by_name )
-  {
-    report::print_html_player( os, *player );
+  timings.head = util::wall_time() - start;
 
-    // Pets
-    if ( sim.report_pets_separately )
-    {
-      for ( auto& pet : player->pet_list )
-      {
-        if ( pet->summoned && !pet->quiet )
-          report::print_html_player( os, *pet );
-      }
-    }
-  }
+  // Report Players
+  start = util::wall_time();
+  write_sections( os, sim, sections, 0, n_player_sections );
 
   print_html_sim_summary( os, sim );
+  print_html_cpu_profile( os, sim );
 
   if ( sim.report_raw_abilities )
     raw_ability_summary::print( os, sim );
 
   // Report Targets
-  if ( sim.report_targets )
-  {
-    for ( auto& player : sim.targets_by_name )
-    {
-      report::print_html_player( os, *player );
-
-      // Pets
-      if ( sim.report_pets_separately )
-      {
-        for ( auto& pet : player->pet_list )
-        {
-          // if ( pet -> summoned )
-          report::print_html_player( os, *pet );
-        }
-      }
-    }
-  }
+  write_sections( os, sim, sections, n_player_sections, sections.size() );
+  timings.body = util::wall_time() - start;
 
+  start = util::wall_time();
   print_html_help_boxes( os, sim );
 
   // jQuery
@@ -1455,8 +1663,13 @@ void print_html_( report::sc_html_stream& os, sim_t& sim )
   os << "</script>\n"
      << "</body>\n\n"
      << "</html>\n";
+
+  timings.scripts = util::wall_time() - start;
 }
 
+// Chart data collector of the thread rendering a report section
+thread_local report::chart_data_collector_t* current_chart_data_collector = nullptr;
+
 }  // UNNAMED NAMESPACE ====================================================
 
 namespace report
@@ -1482,7 +1695,48 @@ void print_html( sim_t& sim )
   }
 
   // Print html report
-  print_html_( s, sim );
+  html_timings_t timings;
+  print_html_( s, sim, timings );
+
+  if ( ! sim.profileset_enabled )
+  {
+    fmt::print( "html report phases: render={:.3f}s ({} sections, {} threads) head={:.3f}s body={:.3f}s scripts={:.3f}s\n",
+        timings.render, timings.sections, timings.threads, timings.head, timings.body, timings.scripts );
+  }
+}
+
+// chart_data_collector_t ===================================================
+
+report::chart_data_collector_t* chart_data_collector_t::current()
+{
+  return current_chart_data_collector;
+}
+
+void chart_data_collector_t::set_current( chart_data_collector_t* collector )
+{
+  current_chart_data_collector = collector;
+}
+
+// Mirrors sim_t::add_chart_data
+void chart_data_collector_t::add( const highchart::chart_t& chart )
+{
+  if ( chart.toggle_id_str_.empty() )
+  {
+    on_ready_chart_data.push_back( chart.to_aggregate_string( false ) );
+  }
+  else
+  {
+    chart_data.emplace_back( chart.toggle_id_str_, chart.to_data() );
+  }
+}
+
+void chart_data_collector_t::merge( sim_t& sim ) const
+{
+  range::append( sim.on_ready_chart_data, on_ready_chart_data );
+  for ( const auto& data : chart_data )
+  {
+    sim.chart_data[ data.first ].push_back( data.second );
+  }
 }
 
 }  // report
@@ -0,0 +1,259 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "simulationcraft.hpp"
+#include "sc_report.hpp"
+
+namespace
+{  // UNNAMED NAMESPACE ==========================================
+
+const char ITERATION_DATA_MAGIC[ 8 ] = { 'S', 'I', 'M', 'C', 'I', 'T', 'E', 'R' };
+const uint32_t ITERATION_DATA_VERSION = 1;
+
+uint64_t double_bits( double v )
+{
+  uint64_t bits;
+  std::memcpy( &bits, &v, sizeof( bits ) );
+  return bits;
+}
+
+bool little_endian_host()
+{
+  const uint16_t probe = 1;
+  uint8_t first;
+  std::memcpy( &first, &probe, sizeof( first ) );
+  return first == 1;
+}
+
+// Values are stored in little-endian byte order regardless of the host
+template <typename T>
+T to_little_endian( T v )
+{
+  if ( little_endian_host() )
+  {
+    return v;
+  }
+
+  T swapped = 0;
+  for ( size_t i = 0; i < sizeof( T ); ++i )
+  {
+    swapped = static_cast<T>( ( swapped << 8 ) | ( v & 0xFF ) );
+    v >>= 8;
+  }
+  return swapped;
+}
+
+bool write_raw( FILE* file, const void* data, size_t size )
+{
+  return size == 0 || std::fwrite( data, size, 1, file ) == 1;
+}
+
+template <typename T>
+bool write_value( FILE* file, T v )
+{
+  v = to_little_endian( v );
+  return write_raw( file, &v, sizeof( v ) );
+}
+
+bool write_values( FILE* file, const std::vector<uint64_t>& values )
+{
+  if ( little_endian_host() )
+  {
+    return write_raw( file, values.data(), values.size() * sizeof( uint64_t ) );
+  }
+
+  std::vector<uint64_t> swapped;
+  swapped.reserve( values.size() );
+  range::transform( values, std::back_inserter( swapped ), []( uint64_t v ) { return to_little_endian( v ); } );
+  return write_raw( file, swapped.data(), swapped.size() * sizeof( uint64_t ) );
+}
+
+}  // UNNAMED NAMESPACE ====================================================
+
+namespace report
+{
+
+// iteration_data_file_t ====================================================
+
+iteration_data_file_t::iteration_data_file_t( const std::string& path ) :
+  file( path, "wb" )
+{ }
+
+bool iteration_data_file_t::write_header( const std::vector<column_t>& columns )
+{
+  bool ok = write_raw( file, ITERATION_DATA_MAGIC, sizeof( ITERATION_DATA_MAGIC ) );
+  ok = ok && write_value( file, ITERATION_DATA_VERSION );
+  ok = ok && write_value( file, as<uint32_t>( columns.size() ) );
+
+  size_t size = sizeof( ITERATION_DATA_MAGIC ) + 2 * sizeof( uint32_t );
+  for ( const auto& column : columns )
+  {
+    ok = ok && write_value( file, static_cast<uint32_t>( column.type ) );
+    ok = ok && write_value( file, as<uint32_t>( column.name.size() ) );
+    ok = ok && write_raw( file, column.name.data(), column.name.size() );
+
+    size += 2 * sizeof( uint32_t ) + column.name.size();
+    names.push_back( column.name );
+  }
+
+  // Keep blocks 8 byte aligned
+  static const char padding[ 8 ] = {};
+  return ok && write_raw( file, padding, ( 8 - size % 8 ) % 8 );
+}
+
+void iteration_data_file_t::write_block( const std::vector<column_t>& columns )
+{
+  if ( columns.empty() || columns.front().data.empty() )
+  {
+    return;
+  }
+
+  auto_lock_t lock( mutex );
+
+  // Export stops at the first error, which the main thread reports once the sim threads are done
+  if ( ! error_str.empty() )
+  {
+    return;
+  }
+
+  // The first block defines the columns of the file, every sim thread uses the same profile so
+  // the columns of the other threads must match.
+  if ( names.empty() )
+  {
+    if ( ! write_header( columns ) )
+    {
+      error_str = "Failed to write iteration data file header";
+      return;
+    }
+  }
+  else if ( names.size() != columns.size() ||
+            ! std::equal( names.begin(), names.end(), columns.begin(),
+              []( const std::string& name, const column_t& column ) { return name == column.name; } ) )
+  {
+    error_str = "Iteration data columns differ between sim threads";
+    return;
+  }
+
+  uint64_t rows = columns.front().data.size();
+  bool ok = write_value( file, rows );
+  for ( const auto& column : columns )
+  {
+    assert( column.data.size() == rows );
+    ok = ok && write_values( file, column.data );
+  }
+
+  if ( ! ok )
+  {
+    error_str = "Failed to write iteration data file";
+  }
+}
+
+std::string iteration_data_file_t::error() const
+{
+  auto_lock_t lock( mutex );
+
+  return error_str;
+}
+
+// iteration_data_output_t ==================================================
+
+iteration_data_output_t::iteration_data_output_t( std::shared_ptr<iteration_data_file_t> f, const sim_t& sim ) :
+  file( std::move( f ) ), rows( 0 )
+{
+  using column_t = iteration_data_file_t::column_t;
+
+  columns.emplace_back( "iteration", iteration_data_file_t::COLUMN_UINT64 );
+  columns.emplace_back( "seed", iteration_data_file_t::COLUMN_UINT64 );
+  columns.emplace_back( "thread", iteration_data_file_t::COLUMN_UINT64 );
+  columns.emplace_back( "fight_length", iteration_data_file_t::COLUMN_DOUBLE );
+  columns.emplace_back( "raid_dps", iteration_data_file_t::COLUMN_DOUBLE );
+
+  for ( const player_t* p : sim.player_no_pet_list )
+  {
+    columns.push_back( column_t( p -> name_str + "/dps", iteration_data_file_t::COLUMN_DOUBLE ) );
+    sources.emplace_back( p, nullptr );
+
+    auto add_stats = [ this, p ]( const player_t* actor, const std::string& prefix ) {
+      for ( const stats_t* s : actor -> stats_list )
+      {
+        if ( s -> type != STATS_DMG )
+        {
+          continue;
+        }
+
+        columns.push_back( column_t( prefix + s -> name_str, iteration_data_file_t::COLUMN_DOUBLE ) );
+        sources.emplace_back( p, s );
+      }
+    };
+
+    add_stats( p, p -> name_str + "/" );
+    for ( const pet_t* pet : p -> pet_list )
+    {
+      add_stats( pet, p -> name_str + "/" + pet -> name_str + "/" );
+    }
+  }
+
+  range::for_each( columns, []( column_t& column ) { column.data.reserve( BLOCK_ROWS ); } );
+}
+
+void iteration_data_output_t::collect( const sim_t& sim )
+{
+  double fight_length = sim.current_time().total_seconds();
+
+  columns[ 0 ].data.push_back( as<uint64_t>( sim.iteration_index ) );
+  columns[ 1 ].data.push_back( sim.seed );
+  columns[ 2 ].data.push_back( as<uint64_t>( sim.thread_index ) );
+  columns[ 3 ].data.push_back( double_bits( fight_length ) );
+  columns[ 4 ].data.push_back( double_bits( fight_length > 0 ? sim.iteration_dmg / fight_length : 0 ) );
+
+  const player_t* active = sim.single_actor_batch ? sim.player_no_pet_list[ sim.current_index ] : nullptr;
+
+  for ( size_t i = 0; i < sources.size(); ++i )
+  {
+    const player_t* p = sources[ i ].first;
+    const stats_t* s = sources[ i ].second;
+    double value;
+
+    // Single actor batch simulates one player at a time, the others have no data for the iteration
+    if ( active && active != p )
+    {
+      value = std::numeric_limits<double>::quiet_NaN();
+    }
+    else if ( s )
+    {
+      value = s -> last_iteration_amount;
+    }
+    else
+    {
+      double dmg = p -> iteration_dmg;
+      range::for_each( p -> pet_list, [ &dmg ]( const pet_t* pet ) { dmg += pet -> iteration_dmg; } );
+
+      double uptime = p -> composite_active_time().total_seconds();
+      value = uptime > 0 ? dmg / uptime : 0;
+    }
+
+    columns[ 5 + i ].data.push_back( double_bits( value ) );
+  }
+
+  if ( ++rows == BLOCK_ROWS )
+  {
+    flush();
+  }
+}
+
+void iteration_data_output_t::flush()
+{
+  if ( rows == 0 )
+  {
+    return;
+  }
+
+  file -> write_block( columns );
+
+  range::for_each( columns, []( iteration_data_file_t::column_t& column ) { column.data.clear(); } );
+  rows = 0;
+}
+
+}  // report
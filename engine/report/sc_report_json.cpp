@@ -189,6 +189,41 @@ void to_json( JsonOutput root, const stats_t::stats_results_t& sr )
   root[ "pct" ] = sr.pct;
 }
 
+void stat_cache_to_json( JsonOutput root, const player_t& p )
+{
+  root.make_array();
+  for ( cache_e c = CACHE_NONE; c < CACHE_MAX; ++c )
+  {
+    if ( p.cache.hits[ c ] + p.cache.misses[ c ] + p.cache.invalidations[ c ] == 0 )
+    {
+      continue;
+    }
+
+    auto node = root.add();
+    node[ "name" ] = util::cache_type_string( c );
+    node[ "hits" ] = p.cache.hits[ c ];
+    node[ "misses" ] = p.cache.misses[ c ];
+    node[ "invalidations" ] = p.cache.invalidations[ c ];
+  }
+}
+
+void callback_dispatch_to_json( JsonOutput root, const player_t& p )
+{
+  root.make_array();
+  for ( const auto& a : p.action_list )
+  {
+    if ( a -> callbacks_checked == 0 )
+    {
+      continue;
+    }
+
+    auto node = root.add();
+    node[ "name" ] = a -> name();
+    node[ "checked" ] = a -> callbacks_checked;
+    node[ "fired" ] = a -> callbacks_fired;
+  }
+}
+
 void procs_to_json( JsonOutput root, const player_t& p )
 {
   root.make_array();
@@ -450,13 +485,13 @@ void to_json( JsonOutput root, const player_t& p,
 }
 
 void to_json( JsonOutput root,
-              const std::vector<player_collected_data_t::action_sequence_data_t>& asd,
+              const player_collected_data_t::action_sequence_t& asd,
               const std::vector<resource_e>& relevant_resources,
               const sim_t& sim )
 {
   root.make_array();
 
-  range::for_each( asd, [ &root, &relevant_resources, &sim ]( const player_collected_data_t::action_sequence_data_t& entry ) {
+  asd.for_each( [ &root, &relevant_resources, &sim ]( const player_collected_data_t::action_sequence_data_t& entry ) {
     auto json = root.add();
 
     json[ "time" ] = entry.time;
@@ -480,7 +515,7 @@ void to_json( JsonOutput root,
     {
       auto buffs = json[ "buffs" ];
       buffs.make_array();
-      range::for_each( entry.buff_list, [ &buffs, &sim ]( const std::pair< buff_t*, std::vector<double> > data ) {
+      range::for_each( entry.buff_list, [ &buffs, &sim ]( const std::pair< buff_t*, std::vector<double> >& data ) {
         auto entry = buffs.add();
 
         entry[ "id" ] = data.first -> data_reporting().id();
@@ -498,7 +533,7 @@ void to_json( JsonOutput root,
     {
       auto cooldowns = json[ "cooldowns" ];
       cooldowns.make_array();
-      range::for_each( entry.cooldown_list, [ &cooldowns ]( const std::pair< cooldown_t*, std::vector<double> > data ) {
+      range::for_each( entry.cooldown_list, [ &cooldowns ]( const std::pair< cooldown_t*, std::vector<double> >& data ) {
         auto entry = cooldowns.add();
 
         entry[ "name" ] = data.first -> name();
@@ -512,12 +547,12 @@ void to_json( JsonOutput root,
       auto targets = json[ "targets" ];
       targets.make_array();
       range::for_each( entry.target_list, [ &targets ]
-          ( const std::pair< player_t*, std::vector< std::pair< buff_t*, std::vector<double> > > > target_data ) {
+          ( const std::pair< const player_t*, std::vector< std::pair< buff_t*, std::vector<double> > > >& target_data ) {
         auto target_entry = targets.add();
         target_entry[ "name" ] = target_data.first -> name();
         auto debuffs = target_entry[ "debuffs" ];
         debuffs.make_array();
-        range::for_each( target_data.second, [ &debuffs ]( const std::pair< buff_t*, std::vector<double> > data ) {
+        range::for_each( target_data.second, [ &debuffs ]( const std::pair< buff_t*, std::vector<double> >& data ) {
           auto entry = debuffs.add();
           entry[ "name" ] = data.first -> name();
           entry[ "stack" ] = data.second[ 0 ];
@@ -855,6 +890,16 @@ void to_json( JsonOutput& arr, const player_t& p )
       gains_to_json( root[ "gains" ], p );
     }
 
+    if ( p.sim -> report_stat_cache && p.cache.active )
+    {
+      stat_cache_to_json( root[ "stat_cache" ], p );
+    }
+
+    if ( p.sim -> report_callbacks )
+    {
+      callback_dispatch_to_json( root[ "callback_dispatch" ], p );
+    }
+
     stats_to_json( root[ "stats" ], p.stats_list );
 
     // add pet stats as a separate property
@@ -897,218 +942,384 @@ void to_json( JsonOutput& arr, const raid_event_t& event )
   add_non_zero( root, "saved_duration", event.saved_duration );
 }
 
-void iteration_data_to_json( JsonOutput root, const std::vector<iteration_data_entry_t>& entries )
-{
-  root.make_array();
-
-  range::for_each( entries, [ &root ]( const iteration_data_entry_t& entry ) {
-    auto json_entry = root.add();
-
-    json_entry[ "metric" ] = entry.metric;
-    json_entry[ "seed" ] = entry.seed;
-    json_entry[ "target_health" ] = entry.target_health;
-  } );
-}
+using json_writer_t = PrettyWriter<FileWriteStream>;
 
-void to_json( JsonOutput root, const sim_t& sim )
+void check_written( bool accepted )
 {
-  // Sim-scope options
-  auto options_root = root[ "options" ];
-
-  options_root[ "debug" ] = sim.debug;
-  options_root[ "max_time" ] = sim.max_time.total_seconds();
-  options_root[ "expected_iteration_time" ] = sim.expected_iteration_time.total_seconds();
-  options_root[ "vary_combat_length" ] = sim.vary_combat_length;
-  options_root[ "iterations" ] = sim.iterations;
-  options_root[ "target_error" ] = sim.target_error;
-  options_root[ "threads" ] = sim.threads;
-  options_root[ "seed" ] = sim.seed;
-  options_root[ "single_actor_batch" ] = sim.single_actor_batch;
-  options_root[ "queue_lag" ] = sim.queue_lag;
-  options_root[ "queue_lag_stddev" ] = sim.queue_lag_stddev;
-  options_root[ "gcd_lag" ] = sim.gcd_lag;
-  options_root[ "gcd_lag_stddev" ] = sim.gcd_lag_stddev;
-  options_root[ "channel_lag" ] = sim.channel_lag;
-  options_root[ "channel_lag_stddev" ] = sim.channel_lag_stddev;
-  options_root[ "queue_gcd_reduction" ] = sim.queue_gcd_reduction;
-  options_root[ "strict_gcd_queue" ] = sim.strict_gcd_queue;
-  options_root[ "confidence" ] = sim.confidence;
-  options_root[ "confidence_estimator" ] = sim.confidence_estimator;
-  options_root[ "world_lag" ] =  sim.world_lag;
-  options_root[ "world_lag_stddev" ] =  sim.world_lag_stddev;
-  options_root[ "travel_variance" ] = sim.travel_variance;
-  options_root[ "default_skill" ] = sim.default_skill;
-  options_root[ "reaction_time" ] =  sim.reaction_time;
-  options_root[ "regen_periodicity" ] =  sim.regen_periodicity;
-  options_root[ "ignite_sampling_delta" ] =  sim.ignite_sampling_delta;
-  options_root[ "fixed_time" ] = sim.fixed_time;
-  options_root[ "optimize_expressions" ] = sim.optimize_expressions;
-  options_root[ "optimal_raid" ] = sim.optimal_raid;
-  options_root[ "log" ] = sim.log;
-  options_root[ "debug_each" ] = sim.debug_each;
-  options_root[ "stat_cache" ] = sim.stat_cache;
-  options_root[ "max_aoe_enemies" ] = sim.max_aoe_enemies;
-  options_root[ "show_etmi" ] = sim.show_etmi;
-  options_root[ "tmi_window_global" ] = sim.tmi_window_global;
-  options_root[ "tmi_bin_size" ] = sim.tmi_bin_size;
-  options_root[ "enemy_death_pct" ] = sim.enemy_death_pct;
-  options_root[ "challenge_mode" ] = sim.challenge_mode;
-  options_root[ "timewalk" ] = sim.timewalk;
-  options_root[ "pvp_crit" ] = sim.pvp_crit;
-  options_root[ "rng" ] = sim.rng();
-  options_root[ "deterministic" ] = sim.deterministic;
-  options_root[ "average_range" ] = sim.average_range;
-  options_root[ "average_gauss" ] = sim.average_gauss;
-  options_root[ "fight_style" ] = sim.fight_style;
-  options_root[ "default_aura_delay" ] = sim.default_aura_delay;
-  options_root[ "default_aura_delay_stddev" ] = sim.default_aura_delay_stddev;
-
-  to_json( options_root[ "dbc" ], sim.dbc );
-
-  if ( sim.scaling -> calculate_scale_factors )
+  if ( ! accepted )
   {
-    auto scaling_root = options_root[ "scaling" ];
-    scaling_root[ "calculate_scale_factors" ] = sim.scaling -> calculate_scale_factors;
-    scaling_root[ "normalize_scale_factors" ] = sim.scaling -> normalize_scale_factors;
-    add_non_zero( scaling_root, "scale_only", sim.scaling -> scale_only_str );
-    add_non_zero( scaling_root, "scale_over",  sim.scaling -> scale_over );
-    add_non_zero( scaling_root, "scale_over_player", sim.scaling -> scale_over_player );
-    add_non_default( scaling_root, "scale_delta_multiplier", sim.scaling -> scale_delta_multiplier, 1.0 );
-    add_non_zero( scaling_root, "positive_scale_delta", sim.scaling -> positive_scale_delta );
-    add_non_zero( scaling_root, "scale_lag", sim.scaling -> scale_lag );
-    add_non_zero( scaling_root, "center_scale_delta", sim.scaling -> center_scale_delta );
+    throw std::runtime_error("JSON Writer did not accept document.");
   }
+}
+
+/**
+ * Build a part of the report with JsonOutput in a scratch document, and stream the members of the
+ * resulting object to the writer. The scratch document is released once it is written, so the full
+ * report is never held in memory at once.
+ */
+template <typename F>
+void write_members( json_writer_t& writer, F fn )
+{
+  Document doc;
+  doc.SetObject();
+
+  fn( JsonOutput( doc, doc ) );
 
-  // Overrides
-  auto overrides = root[ "overrides" ];
-  add_non_zero( overrides, "arcane_intellect", sim.overrides.arcane_intellect );
-  add_non_zero( overrides, "battle_shout", sim.overrides.battle_shout );
-  add_non_zero( overrides, "power_word_fortitude", sim.overrides.power_word_fortitude );
-  add_non_zero( overrides, "chaos_brand", sim.overrides.chaos_brand );
-  add_non_zero( overrides, "mystic_touch", sim.overrides.mystic_touch );
-  add_non_zero( overrides, "mortal_wounds", sim.overrides.mortal_wounds );
-  add_non_zero( overrides, "bleeding", sim.overrides.bleeding );
-  add_non_zero( overrides, "bloodlust", sim.overrides.bloodlust );
-  if ( sim.overrides.bloodlust )
+  for ( auto& member : doc.GetObject() )
   {
-    add_non_zero( overrides, "bloodlust_percent", sim.bloodlust_percent );
-    add_non_zero( overrides, "bloodlust_time", sim.bloodlust_time );
+    check_written( member.name.Accept( writer ) );
+    check_written( member.value.Accept( writer ) );
   }
+}
+
+/**
+ * Stream an array of report entries to the writer, building each entry in its own scratch document.
+ * The builder may add zero or more values to the array it is given.
+ */
+template <typename T, typename F>
+void write_array( json_writer_t& writer, const char* name, const T& container, F fn )
+{
+  check_written( writer.Key( name ) );
+  check_written( writer.StartArray() );
 
-  if ( ! sim.overrides.target_health.empty() )
+  for ( const auto& entry : container )
   {
-    overrides[ "target_health" ] = sim.overrides.target_health;
+    Document doc;
+    doc.SetArray();
+
+    JsonOutput arr( doc, doc );
+    fn( arr, entry );
+
+    for ( const auto& value : doc.GetArray() )
+    {
+      check_written( value.Accept( writer ) );
+    }
   }
 
-  // Players
-  JsonOutput players_arr = root[ "players" ].make_array();
+  check_written( writer.EndArray() );
+}
+
+void iteration_data_to_json( json_writer_t& writer, const char* name, const std::vector<iteration_data_entry_t>& entries )
+{
+  check_written( writer.Key( name ) );
+  check_written( writer.StartArray() );
+
+  range::for_each( entries, [ &writer ]( const iteration_data_entry_t& entry ) {
+    check_written( writer.StartObject() );
+
+    check_written( writer.Key( "metric" ) );
+    check_written( writer.Double( entry.metric ) );
+    check_written( writer.Key( "seed" ) );
+    check_written( writer.Uint64( entry.seed ) );
+    check_written( writer.Key( "target_health" ) );
+    check_written( writer.StartArray() );
+    range::for_each( entry.target_health, [ &writer ]( uint64_t health ) {
+      check_written( writer.Uint64( health ) );
+    } );
+    check_written( writer.EndArray() );
 
-  range::for_each( sim.player_no_pet_list.data(), [ &players_arr ]( const player_t* p ) {
-    to_json( players_arr, *p );
+    check_written( writer.EndObject() );
   } );
 
-  if ( sim.profilesets.n_profilesets() > 0 )
-  {
-    auto profileset_root = root[ "profilesets" ];
-    sim.profilesets.output_json( sim, profileset_root );
-  }
+  check_written( writer.EndArray() );
+}
+
+void to_json( json_writer_t& writer, const sim_t& sim )
+{
+  check_written( writer.Key( "sim" ) );
+  check_written( writer.StartObject() );
+
+  write_members( writer, [ &sim ]( JsonOutput root ) {
+    // Sim-scope options
+    auto options_root = root[ "options" ];
+
+    options_root[ "debug" ] = sim.debug;
+    options_root[ "max_time" ] = sim.max_time.total_seconds();
+    options_root[ "expected_iteration_time" ] = sim.expected_iteration_time.total_seconds();
+    options_root[ "vary_combat_length" ] = sim.vary_combat_length;
+    options_root[ "iterations" ] = sim.iterations;
+    options_root[ "target_error" ] = sim.target_error;
+    options_root[ "threads" ] = sim.threads;
+    options_root[ "seed" ] = sim.seed;
+    options_root[ "single_actor_batch" ] = sim.single_actor_batch;
+    options_root[ "queue_lag" ] = sim.queue_lag;
+    options_root[ "queue_lag_stddev" ] = sim.queue_lag_stddev;
+    options_root[ "gcd_lag" ] = sim.gcd_lag;
+    options_root[ "gcd_lag_stddev" ] = sim.gcd_lag_stddev;
+    options_root[ "channel_lag" ] = sim.channel_lag;
+    options_root[ "channel_lag_stddev" ] = sim.channel_lag_stddev;
+    options_root[ "queue_gcd_reduction" ] = sim.queue_gcd_reduction;
+    options_root[ "strict_gcd_queue" ] = sim.strict_gcd_queue;
+    options_root[ "confidence" ] = sim.confidence;
+    options_root[ "confidence_estimator" ] = sim.confidence_estimator;
+    options_root[ "world_lag" ] =  sim.world_lag;
+    options_root[ "world_lag_stddev" ] =  sim.world_lag_stddev;
+    options_root[ "travel_variance" ] = sim.travel_variance;
+    options_root[ "default_skill" ] = sim.default_skill;
+    options_root[ "reaction_time" ] =  sim.reaction_time;
+    options_root[ "regen_periodicity" ] =  sim.regen_periodicity;
+    options_root[ "ignite_sampling_delta" ] =  sim.ignite_sampling_delta;
+    options_root[ "fixed_time" ] = sim.fixed_time;
+    options_root[ "optimize_expressions" ] = sim.optimize_expressions;
+    options_root[ "compile_expressions" ] = sim.compile_expressions;
+    options_root[ "sample_data_sketch" ] = sim.sample_data_sketch;
+    options_root[ "optimal_raid" ] = sim.optimal_raid;
+    options_root[ "log" ] = sim.log;
+    options_root[ "debug_each" ] = sim.debug_each;
+    options_root[ "stat_cache" ] = sim.stat_cache;
+    options_root[ "max_aoe_enemies" ] = sim.max_aoe_enemies;
+    options_root[ "show_etmi" ] = sim.show_etmi;
+    options_root[ "tmi_window_global" ] = sim.tmi_window_global;
+    options_root[ "tmi_bin_size" ] = sim.tmi_bin_size;
+    options_root[ "enemy_death_pct" ] = sim.enemy_death_pct;
+    options_root[ "challenge_mode" ] = sim.challenge_mode;
+    options_root[ "timewalk" ] = sim.timewalk;
+    options_root[ "pvp_crit" ] = sim.pvp_crit;
+    options_root[ "rng" ] = sim.rng();
+    options_root[ "deterministic" ] = sim.deterministic;
+    options_root[ "average_range" ] = sim.average_range;
+    options_root[ "average_gauss" ] = sim.average_gauss;
+    options_root[ "fight_style" ] = sim.fight_style;
+    options_root[ "default_aura_delay" ] = sim.default_aura_delay;
+    options_root[ "default_aura_delay_stddev" ] = sim.default_aura_delay_stddev;
+
+    to_json( options_root[ "dbc" ], sim.dbc );
+
+    if ( sim.scaling -> calculate_scale_factors )
+    {
+      auto scaling_root = options_root[ "scaling" ];
+      scaling_root[ "calculate_scale_factors" ] = sim.scaling -> calculate_scale_factors;
+      scaling_root[ "normalize_scale_factors" ] = sim.scaling -> normalize_scale_factors;
+      add_non_zero( scaling_root, "scale_only", sim.scaling -> scale_only_str );
+      add_non_zero( scaling_root, "scale_over",  sim.scaling -> scale_over );
+      add_non_zero( scaling_root, "scale_over_player", sim.scaling -> scale_over_player );
+      add_non_default( scaling_root, "scale_delta_multiplier", sim.scaling -> scale_delta_multiplier, 1.0 );
+      add_non_zero( scaling_root, "positive_scale_delta", sim.scaling -> positive_scale_delta );
+      add_non_zero( scaling_root, "scale_lag", sim.scaling -> scale_lag );
+      add_non_zero( scaling_root, "center_scale_delta", sim.scaling -> center_scale_delta );
+    }
+
+    // Overrides
+    auto overrides = root[ "overrides" ];
+    add_non_zero( overrides, "arcane_intellect", sim.overrides.arcane_intellect );
+    add_non_zero( overrides, "battle_shout", sim.overrides.battle_shout );
+    add_non_zero( overrides, "power_word_fortitude", sim.overrides.power_word_fortitude );
+    add_non_zero( overrides, "chaos_brand", sim.overrides.chaos_brand );
+    add_non_zero( overrides, "mystic_touch", sim.overrides.mystic_touch );
+    add_non_zero( overrides, "mortal_wounds", sim.overrides.mortal_wounds );
+    add_non_zero( overrides, "bleeding", sim.overrides.bleeding );
+    add_non_zero( overrides, "bloodlust", sim.overrides.bloodlust );
+    if ( sim.overrides.bloodlust )
+    {
+      add_non_zero( overrides, "bloodlust_percent", sim.bloodlust_percent );
+      add_non_zero( overrides, "bloodlust_time", sim.bloodlust_time );
+    }
+
+    if ( ! sim.overrides.target_health.empty() )
+    {
+      overrides[ "target_health" ] = sim.overrides.target_health;
+    }
+  } );
+
+  // Players, each player is built and written separately
+  write_array( writer, "players", sim.player_no_pet_list.data(), []( JsonOutput& arr, const player_t* p ) {
+    to_json( arr, *p );
+  } );
+
+  write_members( writer, [ &sim ]( JsonOutput root ) {
+    if ( sim.profilesets.n_profilesets() > 0 )
+    {
+      auto profileset_root = root[ "profilesets" ];
+      sim.profilesets.output_json( sim, profileset_root );
+    }
+
+    auto stats_root = root[ "statistics" ];
+    stats_root[ "elapsed_cpu_seconds" ] = sim.elapsed_cpu;
+    stats_root[ "elapsed_time_seconds" ] = sim.elapsed_time;
+    stats_root[ "init_time_seconds" ] = sim.init_time;
+    stats_root[ "merge_time_seconds" ] = sim.merge_time;
+    stats_root[ "analyze_time_seconds" ] = sim.analyze_time;
+    if ( ! sim.init_profile.entries.empty() )
+    {
+      auto init_arr = stats_root[ "init_profile" ].make_array();
+      for ( const auto entry : sim.init_profile.sorted() )
+      {
+        auto obj = init_arr.add();
+        if ( ! entry -> actor.empty() )
+        {
+          obj[ "actor" ] = entry -> actor;
+        }
+        obj[ "group" ] = entry -> group;
+        obj[ "phase" ] = entry -> phase;
+        obj[ "seconds" ] = entry -> time;
+        obj[ "count" ] = entry -> count;
+      }
+    }
+    if ( ! sim.cpu_profile.entries.empty() )
+    {
+      auto cpu_root = stats_root[ "cpu_profile" ];
+      cpu_root[ "sample_rate" ] = sim.cpu_profile.sample_rate;
+      cpu_root[ "sampled_events" ] = sim.cpu_profile.sampled_events;
+      cpu_root[ "seconds" ] = sim.cpu_profile.profiled_time;
+
+      auto cpu_arr = cpu_root[ "entries" ].make_array();
+      for ( const auto entry : sim.cpu_profile.sorted() )
+      {
+        auto obj = cpu_arr.add();
+        if ( ! entry -> actor.empty() )
+        {
+          obj[ "actor" ] = entry -> actor;
+        }
+        obj[ "name" ] = entry -> name;
+        obj[ "phase" ] = cpu_profile_t::phase_string( entry -> phase );
+        obj[ "count" ] = entry -> count;
+        obj[ "self_seconds" ] = entry -> self;
+        obj[ "total_seconds" ] = entry -> total;
+      }
+    }
+    stats_root[ "simulation_length" ] = sim.simulation_length;
+    stats_root[ "total_events_processed" ] = sim.event_mgr.total_events_processed;
+    if ( sim.threads > 1 )
+    {
+      auto threads_arr = stats_root[ "threads" ].make_array();
+      for ( size_t i = 0; i < sim.work_per_thread.size(); ++i )
+      {
+        auto entry = threads_arr.add();
+        entry[ "iterations" ] = sim.work_per_thread[ i ];
+        entry[ "busy_seconds" ] = sim.busy_time_per_thread[ i ];
+        entry[ "run_seconds" ] = sim.run_time_per_thread[ i ];
+        entry[ "steals" ] = sim.steals_per_thread[ i ];
+      }
+    }
+    stats_root[ "event_memory_bytes" ] = sim.event_mgr.event_memory();
+    auto event_alloc_arr = stats_root[ "event_allocation" ].make_array();
+    for ( unsigned i = 0; i < event_manager_t::N_EVENT_SIZE_CLASSES; ++i )
+    {
+      const auto& size_class = sim.event_mgr.event_size_classes[ i ];
+      if ( size_class.n_allocations == 0 )
+      {
+        continue;
+      }
 
-  auto stats_root = root[ "statistics" ];
-  stats_root[ "elapsed_cpu_seconds" ] = sim.elapsed_cpu;
-  stats_root[ "elapsed_time_seconds" ] = sim.elapsed_time;
-  stats_root[ "init_time_seconds" ] = sim.init_time;
-  stats_root[ "merge_time_seconds" ] = sim.merge_time;
-  stats_root[ "analyze_time_seconds" ] = sim.analyze_time;
-  stats_root[ "simulation_length" ] = sim.simulation_length;
-  stats_root[ "total_events_processed" ] = sim.event_mgr.total_events_processed;
-  add_non_zero( stats_root, "raid_dps", sim.raid_dps );
-  add_non_zero( stats_root, "raid_hps", sim.raid_hps );
-  add_non_zero( stats_root, "raid_aps", sim.raid_aps );
-  add_non_zero( stats_root, "total_dmg", sim.total_dmg );
-  add_non_zero( stats_root, "total_heal", sim.total_heal );
-  add_non_zero( stats_root, "total_absorb", sim.total_absorb );
+      auto entry = event_alloc_arr.add();
+      entry[ "size" ] = event_manager_t::event_size_class_bytes( i );
+      entry[ "peak_live" ] = size_class.peak_live;
+      entry[ "allocations" ] = size_class.n_allocations;
+      entry[ "bytes" ] = size_class.bytes;
+    }
+    if ( sim.event_mgr.oversized_allocations > 0 )
+    {
+      auto entry = event_alloc_arr.add();
+      entry[ "size" ] = "oversized";
+      entry[ "peak_live" ] = sim.event_mgr.oversized_peak_live;
+      entry[ "allocations" ] = sim.event_mgr.oversized_allocations;
+    }
+    add_non_zero( stats_root, "raid_dps", sim.raid_dps );
+    add_non_zero( stats_root, "raid_hps", sim.raid_hps );
+    add_non_zero( stats_root, "raid_aps", sim.raid_aps );
+    add_non_zero( stats_root, "total_dmg", sim.total_dmg );
+    add_non_zero( stats_root, "total_heal", sim.total_heal );
+    add_non_zero( stats_root, "total_absorb", sim.total_absorb );
+  } );
 
   if ( sim.report_details != 0 )
   {
     // Targets
-    JsonOutput targets_arr = root[ "targets" ].make_array();
-
-    range::for_each( sim.target_list.data(), [ &targets_arr ]( const player_t* p ) {
-      to_json( targets_arr, *p );
+    write_array( writer, "targets", sim.target_list.data(), []( JsonOutput& arr, const player_t* p ) {
+      to_json( arr, *p );
     } );
 
     // Raid events
     if ( ! sim.raid_events.empty() )
     {
-      auto arr = root[ "raid_events" ].make_array();
-
-      range::for_each( sim.raid_events, [ &arr ]( const std::unique_ptr<raid_event_t>& event ) {
-        to_json( arr, *event );
+      write_array( writer, "raid_events", sim.raid_events,
+        []( JsonOutput& arr, const std::unique_ptr<raid_event_t>& event ) {
+          to_json( arr, *event );
       } );
     }
 
     if ( sim.buff_list.size() > 0 )
     {
-      JsonOutput buffs_arr = root[ "sim_auras" ].make_array();
-      range::for_each( sim.buff_list, [ &buffs_arr ]( const buff_t* b ) {
+      write_array( writer, "sim_auras", sim.buff_list, []( JsonOutput& arr, const buff_t* b ) {
         if ( b -> avg_start.mean() == 0 )
         {
           return;
         }
-        to_json( buffs_arr.add(), b );
+        to_json( arr.add(), b );
       } );
     }
 
-    if ( sim.low_iteration_data.size() > 0 )
+    if ( sim.low_iteration_data.size() > 0 || sim.high_iteration_data.size() > 0 )
     {
-      iteration_data_to_json( root[ "iteration_data" ][ "low" ], sim.low_iteration_data );
-    }
+      check_written( writer.Key( "iteration_data" ) );
+      check_written( writer.StartObject() );
 
-    if ( sim.high_iteration_data.size() > 0 )
-    {
-      iteration_data_to_json( root[ "iteration_data" ][ "high" ], sim.high_iteration_data );
+      if ( sim.low_iteration_data.size() > 0 )
+      {
+        iteration_data_to_json( writer, "low", sim.low_iteration_data );
+      }
+
+      if ( sim.high_iteration_data.size() > 0 )
+      {
+        iteration_data_to_json( writer, "high", sim.high_iteration_data );
+      }
+
+      check_written( writer.EndObject() );
     }
   }
+
+  check_written( writer.EndObject() );
 }
 
+// The report is streamed to the output file as it is generated, instead of assembling the whole
+// document first.
 void print_json_pretty( FILE* o, const sim_t& sim )
 {
-  Document doc;
-  Value& v = doc;
-  v.SetObject();
+  std::array<char, 16384> buffer;
+  FileWriteStream b( o, buffer.data(), buffer.size() );
+  json_writer_t writer( b );
 
-  JsonOutput root( doc, v );
+  check_written( writer.StartObject() );
 
-  root[ "version" ] = SC_VERSION;
-  root[ "ptr_enabled" ] = SC_USE_PTR;
-  root[ "beta_enabled" ] = SC_BETA;
-  root[ "build_date" ] = __DATE__;
-  root[ "build_time" ] = __TIME__;
-  root[ "timestamp" ] = as<uint64_t>( std::time( nullptr ) );
+  write_members( writer, []( JsonOutput root ) {
+    root[ "version" ] = SC_VERSION;
+    root[ "ptr_enabled" ] = SC_USE_PTR;
+    root[ "beta_enabled" ] = SC_BETA;
+    root[ "build_date" ] = __DATE__;
+    root[ "build_time" ] = __TIME__;
+    root[ "timestamp" ] = as<uint64_t>( std::time( nullptr ) );
 #if defined( SC_NO_NETWORKING )
-  root[ "no_networking" ] = true;
+    root[ "no_networking" ] = true;
 #endif
 
-  if ( git_info::available())
+    if ( git_info::available())
+    {
+      root[ "git_revision" ] = git_info::revision();
+      root[ "git_branch" ] = git_info::branch();
+    }
+  } );
+
+  to_json( writer, sim );
+
+  if ( sim.error_list.size() > 0 )
   {
-    root[ "git_revision" ] = git_info::revision();
-    root[ "git_branch" ] = git_info::branch();
+    write_members( writer, [ &sim ]( JsonOutput root ) {
+      root[ "notifications" ] = sim.error_list;
+    } );
   }
 
-  to_json( root[ "sim" ], sim );
+  check_written( writer.EndObject() );
+  b.Flush();
 
-  if ( sim.error_list.size() > 0 )
+  if ( ! writer.IsComplete() )
   {
-    root[ "notifications" ] = sim.error_list;
+    throw std::runtime_error("JSON Writer did not complete document.");
   }
 
-  std::array<char, 16384> buffer;
-  FileWriteStream b( o, buffer.data(), buffer.size() );
-  PrettyWriter<FileWriteStream> writer( b );
-  auto accepted = doc.Accept( writer );
-  if ( !accepted )
+  // The file stream does not report write errors
+  if ( std::fflush( o ) != 0 || std::ferror( o ) )
   {
-    throw std::runtime_error("JSON Writer did not accept document.");
+    throw std::runtime_error("Unable to write the JSON output file.");
   }
 }
 
@@ -1120,12 +1331,14 @@ void print_json( sim_t& sim )
 {
   if ( ! sim.json_file_str.empty() )
   {
-    // Setup file stream and open file
-    io::cfile s( sim.json_file_str, "w" );
+    // The report is written to a temporary file that replaces the output file once it is complete,
+    // so a failed report does not leave a partial file behind
+    std::string tmp_file_str = sim.json_file_str + ".tmp";
+    io::cfile s( tmp_file_str, "w" );
     if ( !s )
     {
       sim.errorf( "Failed to open JSON output file '%s'.",
-                  sim.json_file_str.c_str() );
+                  tmp_file_str.c_str() );
       return;
     }
 
@@ -1142,9 +1355,18 @@ void print_json( sim_t& sim )
         t.start();
       }
       print_json_pretty( s, sim );
+      s.close();
+
+      std::remove( sim.json_file_str.c_str() );
+      if ( std::rename( tmp_file_str.c_str(), sim.json_file_str.c_str() ) != 0 )
+      {
+        throw std::runtime_error( fmt::format( "Unable to rename '{}' to '{}'.", tmp_file_str, sim.json_file_str ) );
+      }
     }
     catch ( const std::exception& e )
     {
+      s.close();
+      std::remove( tmp_file_str.c_str() );
       sim.error( "Error generating JSON report: {}", e.what() );
     }
   }
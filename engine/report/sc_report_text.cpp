@@ -541,6 +541,43 @@ void print_procs( std::ostream& os, const player_t& p )
   }
 }
 
+void print_stat_cache( std::ostream& os, const player_t& p )
+{
+  if ( !p.sim->report_stat_cache || !p.cache.active )
+    return;
+
+  fmt::print( os, "  Stat Cache:\n" );
+  for ( cache_e c = CACHE_NONE; c < CACHE_MAX; ++c )
+  {
+    auto hits = p.cache.hits[ c ], misses = p.cache.misses[ c ];
+    if ( hits + misses + p.cache.invalidations[ c ] == 0 )
+      continue;
+
+    fmt::print( os, "    {:<28} hits={:<12} misses={:<10} invalidations={:<10} hit_rate={:6.2f}%\n",
+        util::cache_type_string( c ),
+        hits, misses, p.cache.invalidations[ c ],
+        hits + misses > 0 ? 100.0 * hits / ( hits + misses ) : 0.0 );
+  }
+}
+
+void print_callback_dispatch( std::ostream& os, const player_t& p )
+{
+  if ( !p.sim->report_callbacks )
+    return;
+
+  fmt::print( os, "  Callback Dispatch:\n" );
+  for ( const auto& a : p.action_list )
+  {
+    if ( a->callbacks_checked == 0 )
+      continue;
+
+    fmt::print( os, "    {:<28} checked={:<12} fired={:<12} fire_rate={:6.2f}%\n",
+        a->signature_str.empty() ? a->name() : a->signature_str,
+        a->callbacks_checked, a->callbacks_fired,
+        100.0 * a->callbacks_fired / a->callbacks_checked );
+  }
+}
+
 void print_uptimes_benefits( std::ostream& os, const player_t& p )
 {
   bool first = true;
@@ -749,6 +786,16 @@ void print_iteration_data( std::ostream& os, const sim_t& sim )
   }
 }
 
+void print_init_profile( std::ostream& os, const sim_t& sim )
+{
+  if ( sim.init_profile.entries.empty() )
+  {
+    return;
+  }
+
+  report::print_init_profile( os, sim.init_profile, "Init Profile" );
+}
+
 void sim_summary_performance( std::ostream& os, sim_t* sim )
 {
   std::time_t cur_time = std::time( nullptr );
@@ -816,6 +863,54 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
       sim->analyze_time,
       sim->iterations * sim->simulation_length.mean() / sim->elapsed_cpu,
       date_str, cur_time );
+
+  if ( sim->threads > 1 )
+  {
+    // Utilization is relative to the longest running thread, so idle time at the tail shows up
+    double max_run_time = *std::max_element( sim->run_time_per_thread.begin(), sim->run_time_per_thread.end() );
+    fmt::print( os, "Thread Utilization:\n" );
+    for ( size_t i = 0; i < sim->work_per_thread.size(); ++i )
+    {
+      fmt::print( os, "  Thread {:3} Iterations: {:9} Busy: {:9.3f}s ({:6.2f}%) Steals: {}\n",
+          i,
+          sim->work_per_thread[ i ],
+          sim->busy_time_per_thread[ i ],
+          max_run_time > 0 ? 100.0 * sim->busy_time_per_thread[ i ] / max_run_time : 0.0,
+          sim->steals_per_thread[ i ] );
+    }
+    fmt::print( os, "\n" );
+  }
+
+  if ( sim->sample_data_sketch > 0 )
+  {
+    fmt::print( os, "Sample Data Sketch: compression={} percentile rank error <= {:.2f}%\n\n",
+        sim->sample_data_sketch,
+        quantile_sketch_t( sim->sample_data_sketch ).rank_error_bound() * 100.0 );
+  }
+
+  fmt::print( os, "Event Allocation:\n" );
+  for ( unsigned i = 0; i < event_manager_t::N_EVENT_SIZE_CLASSES; ++i )
+  {
+    const auto& size_class = sim->event_mgr.event_size_classes[ i ];
+    if ( size_class.n_allocations == 0 )
+    {
+      continue;
+    }
+
+    fmt::print( os, "  Size-Class: {:5} PeakLive: {:7} Allocations: {:11} Bytes: {}\n",
+        event_manager_t::event_size_class_bytes( i ),
+        size_class.peak_live,
+        size_class.n_allocations,
+        size_class.bytes );
+  }
+  if ( sim->event_mgr.oversized_allocations > 0 )
+  {
+    fmt::print( os, "  Oversized        PeakLive: {:7} Allocations: {:11}\n",
+        sim->event_mgr.oversized_peak_live,
+        sim->event_mgr.oversized_allocations );
+  }
+  fmt::print( os, "  Total Bytes: {}\n\n", sim->event_mgr.event_memory() );
+
 #ifdef EVENT_QUEUE_DEBUG
   double total_p = 0;
 
@@ -864,8 +959,8 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
   fmt::print( os, "Total: {:.3f}% Alloc Samples: {}\n",
       total_p,
       sim->event_mgr.n_requested_events );
-  fmt::print( os, "Alloc size used for event_t: {}\n",
-      util::next_power_of_two( 2 * sizeof( event_t ) ) );
+  fmt::print( os, "Alloc size class used for event_t: {}\n",
+      event_manager_t::event_size_class_bytes( event_manager_t::event_size_class( sizeof( event_t ) ) ) );
 #endif
 }
 
@@ -1194,6 +1289,8 @@ void print_player( std::ostream& os, player_t& p )
   print_uptimes_benefits( os, p );
   print_procs( os, p );
   print_player_gains( os, p );
+  print_stat_cache( os, p );
+  print_callback_dispatch( os, p );
   print_player_scale_factors( os, p, p.report_information );
   print_dps_plots( os, p );
   print_waiting_player( os, p );
@@ -1297,6 +1394,7 @@ void print_text_report( std::ostream& os, sim_t* sim, bool detail )
   sim -> profilesets.output_text( *sim, os );
 
   sim_summary_performance( os, sim );
+  print_init_profile( os, *sim );
 
   if ( detail )
   {
@@ -1315,6 +1413,27 @@ void print_text_report( std::ostream& os, sim_t* sim, bool detail )
 
 namespace report
 {
+void print_init_profile( std::ostream& os, const init_profile_t& profile, const std::string& title )
+{
+  double total = 0;
+  range::for_each( profile.entries, [ &total ]( const init_profile_t::entry_t& entry ) {
+    // Nested phases are already included in their parent phase
+    if ( entry.phase.find( '/' ) == std::string::npos )
+    {
+      total += entry.time;
+    }
+  } );
+
+  fmt::print( os, "{}: total={:.3f}s\n", title, total );
+  for ( const auto entry : profile.sorted() )
+  {
+    fmt::print( os, "  {:10.3f}ms {:6.2f}% {:6} {:<24} {}\n", 1000.0 * entry->time,
+        total > 0 ? 100.0 * entry->time / total : 0.0, entry->count,
+        entry->actor.empty() ? "sim" : entry->actor, entry->phase );
+  }
+  fmt::print( os, "\n" );
+}
+
 void print_text( sim_t* sim, bool detail )
 {
   if ( sim->simulation_length.sum() == 0.0 )
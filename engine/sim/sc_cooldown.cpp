@@ -26,6 +26,7 @@ struct recharge_event_t : event_t
 
   void execute() override
   {
+    cooldown_->state_epoch++;
     assert( cooldown_->current_charge < cooldown_->charges );
     cooldown_->current_charge++;
     cooldown_->ready = cooldown_t::ready_init();
@@ -81,6 +82,16 @@ struct ready_trigger_event_t : public player_event_t
   }
 };
 
+// Cooldown state queries only depend on the cooldown state and the current time, memoize them per
+// timestamp and cooldown state epoch.
+template <typename F>
+std::unique_ptr<expr_t> make_cooldown_expr( const std::string& name, const cooldown_t& cd, F f )
+{
+  return make_fn_expr( name, [ &cd, f, cache = expr_epoch_cache_t() ]() mutable {
+    return cache.get( cd.sim.current_time(), cd.state_epoch, f );
+  } );
+}
+
 } // UNNAMED NAMESPACE
 
 cooldown_t::cooldown_t( const std::string& n, player_t& p ) :
@@ -100,7 +111,8 @@ cooldown_t::cooldown_t( const std::string& n, player_t& p ) :
   execute_types_mask( 0u ),
   current_charge( 1 ),
   recharge_multiplier( 1.0 ),
-  base_duration( 0_ms )
+  base_duration( 0_ms ),
+  state_epoch( 0 )
 { }
 
 cooldown_t::cooldown_t( const std::string& n, sim_t& s ) :
@@ -120,7 +132,8 @@ cooldown_t::cooldown_t( const std::string& n, sim_t& s ) :
   execute_types_mask( 0u ),
   current_charge( 1 ),
   recharge_multiplier( 1.0 ),
-  base_duration( 0_ms )
+  base_duration( 0_ms ),
+  state_epoch( 0 )
 { }
 
 /**
@@ -191,6 +204,8 @@ void cooldown_t::adjust_base_duration()
 
 void cooldown_t::adjust_remaining_duration( double delta )
 {
+  state_epoch++;
+
   assert( ongoing() && delta > 0.0 );
 
   timespan_t new_remains, remains;
@@ -234,6 +249,8 @@ void cooldown_t::adjust_remaining_duration( double delta )
 
 void cooldown_t::adjust( timespan_t amount, bool require_reaction )
 {
+  state_epoch++;
+
   // Normal cooldown, just adjust as we see fit
   if ( charges == 1 )
   {
@@ -316,6 +333,8 @@ void cooldown_t::adjust( timespan_t amount, bool require_reaction )
 
 void cooldown_t::reset_init()
 {
+  state_epoch++;
+
   ready = ready_init();
   last_start = 0_ms;
   last_charged = 0_ms;
@@ -331,6 +350,8 @@ void cooldown_t::reset_init()
 
 void cooldown_t::reset( bool require_reaction, int charges_ )
 {
+  state_epoch++;
+
   if ( charges_ == 0 )
     return;
   if ( charges_ < 0 )
@@ -372,6 +393,8 @@ void cooldown_t::reset( bool require_reaction, int charges_ )
 
 void cooldown_t::start( action_t* a, timespan_t _override, timespan_t delay )
 {
+  state_epoch++;
+
   // Zero duration cooldowns are nonsense
   if ( _override == 0_ms || ( _override < 0_ms && duration <= 0_ms ) )
   {
@@ -471,7 +494,7 @@ timespan_t cooldown_t::cooldown_duration( const cooldown_t* cd )
 std::unique_ptr<expr_t> cooldown_t::create_expression( const std::string& name_str )
 {
   if ( name_str == "remains" )
-    return make_mem_fn_expr( name_str, *this, &cooldown_t::remains );
+    return make_cooldown_expr( name_str, *this, [ this ] { return remains(); } );
 
   else if ( name_str == "base_duration" )
   {
@@ -493,11 +516,11 @@ std::unique_ptr<expr_t> cooldown_t::create_expression( const std::string& name_s
     } );
   }
   else if ( name_str == "up" || name_str == "ready" )
-    return make_mem_fn_expr( name_str, *this, &cooldown_t::up );
+    return make_cooldown_expr( name_str, *this, [ this ] { return up(); } );
 
   else if ( name_str == "charges" )
   {
-    return make_fn_expr( name_str, [ this ]
+    return make_cooldown_expr( name_str, *this, [ this ]
     {
       if ( charges <= 1 )
       {
@@ -511,7 +534,7 @@ std::unique_ptr<expr_t> cooldown_t::create_expression( const std::string& name_s
   }
   else if ( name_str == "charges_fractional" )
   {
-    return make_fn_expr( name_str, [ this ]
+    return make_cooldown_expr( name_str, *this, [ this ]
     {
       if ( charges > 1 )
       {
@@ -537,7 +560,7 @@ std::unique_ptr<expr_t> cooldown_t::create_expression( const std::string& name_s
   }
   else if ( name_str == "recharge_time" )
   {
-    return make_fn_expr( name_str, [ this ]
+    return make_cooldown_expr( name_str, *this, [ this ]
     {
       if ( charges <= 1 )
         return remains().total_seconds();
@@ -549,7 +572,7 @@ std::unique_ptr<expr_t> cooldown_t::create_expression( const std::string& name_s
   }
   else if ( name_str == "full_recharge_time" )
   {
-    return make_fn_expr( name_str, [ this ]
+    return make_cooldown_expr( name_str, *this, [ this ]
     {
       if ( charges <= 1 )
       {
@@ -0,0 +1,226 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "simulationcraft.hpp"
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+#  define CPU_PROFILE_USE_RDTSC
+#  if defined( SC_VS )
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#endif
+
+namespace
+{  // UNNAMED NAMESPACE ==========================================
+
+// Folded stack frames are separated by semicolons
+std::string frame_name( const std::string& name )
+{
+  std::string out = name;
+  std::replace( out.begin(), out.end(), ';', '_' );
+  return out;
+}
+
+}  // UNNAMED NAMESPACE ====================================================
+
+// cpu_profile_t ============================================================
+
+const char* cpu_profile_t::phase_string( phase_e phase )
+{
+  switch ( phase )
+  {
+    case PHASE_EVENT:   return "event";
+    case PHASE_READY:   return "ready";
+    case PHASE_EXECUTE: return "execute";
+    case PHASE_IMPACT:  return "impact";
+    case PHASE_TICK:    return "tick";
+    default:            return "unknown";
+  }
+}
+
+// Timestamp counter where available, it is converted to seconds against the wall clock when the
+// profile is finalized
+uint64_t cpu_profile_t::ticks()
+{
+#if defined( CPU_PROFILE_USE_RDTSC )
+  return __rdtsc();
+#else
+  return as<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::high_resolution_clock::now().time_since_epoch() ).count() );
+#endif
+}
+
+size_t cpu_profile_t::child( const void* key, phase_e phase )
+{
+  size_t parent = stack.empty() ? 0 : stack.back().node;
+
+  for ( size_t c : nodes[ parent ].children )
+  {
+    if ( nodes[ c ].key == key && nodes[ c ].phase == phase )
+    {
+      return c;
+    }
+  }
+
+  node_t node;
+  node.key = key;
+  node.phase = phase;
+  node.parent = parent;
+  node.ticks = 0;
+  node.count = 0;
+  nodes.push_back( node );
+  nodes[ parent ].children.push_back( nodes.size() - 1 );
+
+  return nodes.size() - 1;
+}
+
+void cpu_profile_t::execute( event_t* e )
+{
+  if ( nodes.empty() )
+  {
+    nodes.emplace_back();
+    nodes.back().key = nullptr;
+    nodes.back().phase = PHASE_EVENT;
+    nodes.back().parent = 0;
+    nodes.back().ticks = 0;
+    nodes.back().count = 0;
+
+    start_ticks = ticks();
+    start_time = std::chrono::high_resolution_clock::now();
+  }
+
+  // Events of the same type share a frame, the name of the first one is used for the report
+  size_t node = child( &typeid( *e ), PHASE_EVENT );
+  if ( nodes[ node ].name.empty() )
+  {
+    nodes[ node ].name = e -> name();
+  }
+
+  active = true;
+  stack.push_back( { node, ticks() } );
+
+  e -> execute();
+
+  leave();
+  active = false;
+}
+
+void cpu_profile_t::enter( const action_t* action, phase_e phase )
+{
+  size_t node = child( action, phase );
+  if ( nodes[ node ].name.empty() )
+  {
+    nodes[ node ].actor = action -> player -> name_str;
+    nodes[ node ].name = action -> name_str;
+  }
+
+  stack.push_back( { node, ticks() } );
+}
+
+void cpu_profile_t::leave()
+{
+  assert( ! stack.empty() );
+
+  const frame_t& frame = stack.back();
+  node_t& node = nodes[ frame.node ];
+  node.ticks += ticks() - frame.start;
+  node.count++;
+
+  stack.pop_back();
+}
+
+void cpu_profile_t::finalize()
+{
+  active = false;
+  stack.clear();
+
+  if ( nodes.size() <= 1 )
+  {
+    nodes.clear();
+    return;
+  }
+
+  uint64_t elapsed_ticks = ticks() - start_ticks;
+  double scale = elapsed_ticks > 0 ? sample_rate * util::duration_fp_seconds( start_time ) / elapsed_ticks : 0;
+
+  // Nodes are always created after their parent, so a single pass in index order sees the parent
+  // stack of a node before the node itself
+  std::vector<std::string> paths( nodes.size() );
+  for ( size_t i = 1; i < nodes.size(); ++i )
+  {
+    const node_t& node = nodes[ i ];
+
+    uint64_t child_ticks = 0;
+    range::for_each( node.children, [ this, &child_ticks ]( size_t c ) { child_ticks += nodes[ c ].ticks; } );
+    uint64_t self_ticks = node.ticks > child_ticks ? node.ticks - child_ticks : 0;
+
+    std::string frame = node.phase == PHASE_EVENT
+      ? "event:" + frame_name( node.name )
+      : frame_name( node.actor ) + ":" + frame_name( node.name ) + ":" + phase_string( node.phase );
+    paths[ i ] = node.parent == 0 ? frame : paths[ node.parent ] + ";" + frame;
+    folded[ paths[ i ] ] += self_ticks * scale;
+
+    // Recursive frames (e.g. a proc executing the action that triggered it) only count towards
+    // the total time once
+    bool recursive = false;
+    for ( size_t p = node.parent; p != 0 && ! recursive; p = nodes[ p ].parent )
+    {
+      recursive = nodes[ p ].key == node.key && nodes[ p ].phase == node.phase;
+    }
+
+    entry_t entry;
+    entry.actor = node.actor;
+    entry.name = node.name;
+    entry.phase = node.phase;
+    entry.self = self_ticks * scale;
+    entry.total = recursive ? 0 : node.ticks * scale;
+    entry.count = as<double>( node.count ) * sample_rate;
+    add( entry );
+
+    if ( node.parent == 0 )
+    {
+      profiled_time += node.ticks * scale;
+      sampled_events += node.count;
+    }
+  }
+
+  nodes.clear();
+}
+
+void cpu_profile_t::add( const entry_t& entry )
+{
+  auto it = index.emplace( entry.actor + '\0' + entry.name + '\0' + phase_string( entry.phase ), entries.size() );
+  if ( it.second )
+  {
+    entries.push_back( entry );
+  }
+  else
+  {
+    entry_t& e = entries[ it.first -> second ];
+    e.self += entry.self;
+    e.total += entry.total;
+    e.count += entry.count;
+  }
+}
+
+void cpu_profile_t::merge( const cpu_profile_t& other )
+{
+  range::for_each( other.folded, [ this ]( const std::pair<const std::string, double>& stack ) {
+    folded[ stack.first ] += stack.second;
+  } );
+  range::for_each( other.entries, [ this ]( const entry_t& entry ) { add( entry ); } );
+  profiled_time += other.profiled_time;
+  sampled_events += other.sampled_events;
+}
+
+std::vector<const cpu_profile_t::entry_t*> cpu_profile_t::sorted() const
+{
+  std::vector<const entry_t*> out;
+  range::for_each( entries, [ &out ]( const entry_t& entry ) { out.push_back( &entry ); } );
+  range::sort( out, []( const entry_t* l, const entry_t* r ) { return l -> self > r -> self; } );
+  return out;
+}
@@ -0,0 +1,139 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+#ifndef SC_CPU_PROFILE_HPP
+#define SC_CPU_PROFILE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct action_t;
+struct event_t;
+
+/**
+ * Sampling profiler of the event loop, enabled with cpu_profile=<n>. Every n-th event is timed with
+ * the CPU timestamp counter, and the time is attributed to a call tree of the event type and the
+ * actions it runs (ready, execute, impact and tick phases). At the end of the iteration loop the
+ * tree is scaled by the sample rate into seconds, both as folded stacks for flamegraph tools and as
+ * a flat table of the hottest actions.
+ */
+struct cpu_profile_t
+{
+  enum phase_e
+  {
+    PHASE_EVENT = 0,
+    PHASE_READY,
+    PHASE_EXECUTE,
+    PHASE_IMPACT,
+    PHASE_TICK
+  };
+
+  struct entry_t
+  {
+    std::string actor; // Empty for events
+    std::string name;
+    phase_e phase;
+    double self;  // Seconds spent in the frame itself, excluding the frames it called
+    double total; // Seconds spent in the frame, including the frames it called
+    double count;
+  };
+
+  // Times an action phase if the current event is sampled
+  struct scope_t
+  {
+    cpu_profile_t* profile;
+
+    scope_t( cpu_profile_t& p, const action_t* action, phase_e phase ) :
+      profile( p.active ? &p : nullptr )
+    {
+      if ( profile )
+      {
+        profile -> enter( action, phase );
+      }
+    }
+
+    ~scope_t()
+    {
+      if ( profile )
+      {
+        profile -> leave();
+      }
+    }
+  };
+
+  int sample_rate;
+  std::string output_file_str;
+  bool active;
+
+  // Results, in seconds of estimated event loop time
+  std::map<std::string, double> folded;
+  std::vector<entry_t> entries;
+  std::unordered_map<std::string, size_t> index;
+  double profiled_time;
+  uint64_t sampled_events;
+
+  cpu_profile_t() :
+    sample_rate( 0 ), active( false ), profiled_time( 0 ), sampled_events( 0 ),
+    countdown( 0 ), start_ticks( 0 )
+  { }
+
+  /// Returns true if the next event should be executed through execute()
+  bool sample_event()
+  {
+    if ( sample_rate <= 0 || --countdown > 0 )
+    {
+      return false;
+    }
+
+    countdown = sample_rate;
+    return true;
+  }
+
+  /// Execute a sampled event
+  void execute( event_t* e );
+  /// Convert the call tree of the sampled events into results
+  void finalize();
+  void merge( const cpu_profile_t& other );
+  /// Entries by descending self time
+  std::vector<const entry_t*> sorted() const;
+
+  static const char* phase_string( phase_e phase );
+
+private:
+  struct node_t
+  {
+    const void* key;
+    phase_e phase;
+    std::string actor;
+    std::string name;
+    size_t parent;
+    uint64_t ticks;
+    uint64_t count;
+    std::vector<size_t> children;
+  };
+
+  struct frame_t
+  {
+    size_t node;
+    uint64_t start;
+  };
+
+  int countdown;
+  std::vector<node_t> nodes;
+  std::vector<frame_t> stack;
+  uint64_t start_ticks;
+  std::chrono::high_resolution_clock::time_point start_time;
+
+  static uint64_t ticks();
+  size_t child( const void* key, phase_e phase );
+  void enter( const action_t* action, phase_e phase );
+  void leave();
+  void add( const entry_t& entry );
+};
+
+#endif /* SC_CPU_PROFILE_HPP */
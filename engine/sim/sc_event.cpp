@@ -5,6 +5,47 @@
 
 #include "simulationcraft.hpp"
 
+namespace
+{
+// Index of the lowest set bit of a non-zero word
+inline unsigned lowest_set_bit( uint64_t v )
+{
+  assert( v != 0 );
+#if defined( __GNUC__ ) || defined( __clang__ )
+  return static_cast<unsigned>( __builtin_ctzll( v ) );
+#else
+  unsigned n = 0;
+  while ( !( v & 1 ) )
+  {
+    v >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+// First occupied slot >= start in a wheel level, or -1 if none
+int find_occupied_slot( const event_manager_t::wheel_level_t& level, unsigned start )
+{
+  unsigned n_words = as<unsigned>( level.occupied.size() );
+  unsigned word = start / 64;
+  if ( word >= n_words )
+    return -1;
+
+  uint64_t bits = level.occupied[ word ] & ( ~uint64_t( 0 ) << ( start % 64 ) );
+  while ( true )
+  {
+    if ( bits )
+      return static_cast<int>( word * 64 + lowest_set_bit( bits ) );
+
+    if ( ++word == n_words )
+      return -1;
+
+    bits = level.occupied[ word ];
+  }
+}
+} // unnamed namespace
+
 // ==========================================================================
 // Event
 // ==========================================================================
@@ -84,6 +125,10 @@ void event_t::cancel( event_t*& e )
 // Event Manager
 // ==========================================================================
 
+constexpr unsigned event_manager_t::MIN_EVENT_SIZE_SHIFT;
+constexpr unsigned event_manager_t::N_EVENT_SIZE_CLASSES;
+constexpr std::size_t event_manager_t::EVENT_SLAB_SIZE;
+
 // event_manager_t::event_manager_t =========================================
 
 event_manager_t::event_manager_t( sim_t* s )
@@ -92,15 +137,19 @@ event_manager_t::event_manager_t( sim_t* s )
     events_processed( 0 ),
     total_events_processed( 0 ),
     max_events_remaining( 0 ),
-    timing_slice( 0 ),
     global_event_id( 1 ),  // start at 1, so we can identify event -> id == 0
                            // meaning a unscheduled event.
     timing_wheel(),
-    recycled_event_list( nullptr ),
+    wheel_cursor( 0 ),
+    event_size_classes(),
+    event_slabs(),
+    oversized_events(),
+    oversized_peak_live( 0 ),
+    oversized_allocations( 0 ),
     wheel_seconds( 0 ),
-    wheel_size( 0 ),
+    wheel_levels( 0 ),
     wheel_mask( 0 ),
-    wheel_shift( 5 ),
+    wheel_shift( 8 ),
     wheel_granularity( 0.0 ),
     wheel_time( timespan_t::zero() ),
     event_stopwatch( STOPWATCH_THREAD ),
@@ -117,18 +166,29 @@ event_manager_t::event_manager_t( sim_t* s )
     canceled( false )
 #endif /* EVENT_QUEUE_DEBUG */
 {
-  allocated_events.reserve( 100 );
+  for ( auto& size_class : event_size_classes )
+  {
+    size_class.free_list     = nullptr;
+    size_class.current_slab  = -1;
+    size_class.live          = 0;
+    size_class.peak_live     = 0;
+    size_class.n_allocations = 0;
+    size_class.bytes         = 0;
+  }
 }
 
 // event_manager_t::~event_manager_t ========================================
 
 event_manager_t::~event_manager_t()
 {
-  while ( recycled_event_list )
+  for ( auto& slab : event_slabs )
   {
-    event_t* e          = recycled_event_list;
-    recycled_event_list = e->next;
-    free( e );
+    free( slab.data );
+  }
+
+  for ( auto e : oversized_events )
+  {
+    free( event_block_header( e ) );
   }
 }
 
@@ -136,11 +196,6 @@ event_manager_t::~event_manager_t()
 
 void* event_manager_t::allocate_event( const std::size_t size )
 {
-  static const std::size_t SIZE = util::next_power_of_two( 2 * sizeof( event_t ) );
-  assert( SIZE > size );
-  (void)size;
-
-  event_t* e = recycled_event_list;
 #ifdef EVENT_QUEUE_DEBUG
   n_requested_events++;
   if ( size >= event_requested_size_count.size() )
@@ -149,27 +204,72 @@ void* event_manager_t::allocate_event( const std::size_t size )
   }
   event_requested_size_count[ size ]++;
 #endif
-  if ( e )
+
+  static_assert( EVENT_HEADER_SIZE >= sizeof( event_block_header_t ) &&
+                 EVENT_HEADER_SIZE % alignof( std::max_align_t ) == 0,
+                 "Event block header must keep events aligned" );
+
+  unsigned index = event_size_class( size );
+
+  // Events too large for the slabs get their own allocation
+  if ( index == N_EVENT_SIZE_CLASSES )
   {
-    recycled_event_list = e->next;
+    char* block = static_cast<char*>( malloc( size + EVENT_HEADER_SIZE ) );
+    if ( !block )
+    {
+      throw std::bad_alloc();
+    }
+
+#ifdef EVENT_QUEUE_DEBUG
+    n_allocated_events++;
+#endif
+    event_t* e = reinterpret_cast<event_t*>( block + EVENT_HEADER_SIZE );
+    *event_block_header( e ) = { index, as<unsigned>( size ), as<unsigned>( oversized_events.size() ) };
+    oversized_events.push_back( e );
+    oversized_allocations++;
+    oversized_peak_live = std::max( oversized_peak_live, as<unsigned>( oversized_events.size() ) );
+    return e;
   }
-  else
+
+  event_size_class_t& size_class = event_size_classes[ index ];
+  size_class.n_allocations++;
+  if ( ++size_class.live > size_class.peak_live )
+  {
+    size_class.peak_live = size_class.live;
+  }
+
+  if ( event_t* e = size_class.free_list )
   {
-    e = (event_t*)malloc( SIZE );
+    size_class.free_list = e->next;
+    event_block_header( e )->size = as<unsigned>( size );
+    return e;
+  }
+
+  std::size_t block_size = event_size_class_bytes( index );
 
-    if ( !e )
+  // Carve a new block from the current slab of the size class, reserving a new
+  // slab when the current one is exhausted.
+  if ( size_class.current_slab == -1 ||
+       ( event_slabs[ size_class.current_slab ].n_blocks + 1 ) * block_size > EVENT_SLAB_SIZE )
+  {
+    char* data = static_cast<char*>( malloc( EVENT_SLAB_SIZE ) );
+    if ( !data )
     {
       throw std::bad_alloc();
     }
-    else
-    {
+
+    event_slabs.push_back( { data, index, 0 } );
+    size_class.current_slab = as<int>( event_slabs.size() - 1 );
+    size_class.bytes += EVENT_SLAB_SIZE;
+  }
+
 #ifdef EVENT_QUEUE_DEBUG
-      n_allocated_events++;
+  n_allocated_events++;
 #endif
-      allocated_events.push_back( e );
-    }
-  }
 
+  event_slab_t& slab = event_slabs[ size_class.current_slab ];
+  event_t* e = reinterpret_cast<event_t*>( slab.data + block_size * slab.n_blocks++ + EVENT_HEADER_SIZE );
+  *event_block_header( e ) = { index, as<unsigned>( size ), 0 };
   return e;
 }
 
@@ -177,10 +277,43 @@ void* event_manager_t::allocate_event( const std::size_t size )
 
 void event_manager_t::recycle_event( event_t* e )
 {
+  const event_block_header_t* header = event_block_header( e );
+  unsigned index = header->size_class;
+
+  assert( index == event_size_class( header->size ) && "Event block header does not match the event size" );
+
   e->~event_t();
-  e->recycled         = true;
-  e->next             = recycled_event_list;
-  recycled_event_list = e;
+
+  if ( index == N_EVENT_SIZE_CLASSES )
+  {
+    // Swap the last oversized event into the slot of the recycled one
+    unsigned slot = header->index;
+    assert( slot < oversized_events.size() && oversized_events[ slot ] == e );
+    oversized_events[ slot ] = oversized_events.back();
+    event_block_header( oversized_events[ slot ] )->index = slot;
+    oversized_events.pop_back();
+    free( event_block_header( e ) );
+    return;
+  }
+
+  event_size_class_t& size_class = event_size_classes[ index ];
+  e->recycled          = true;
+  e->next              = size_class.free_list;
+  size_class.free_list = e;
+  size_class.live--;
+}
+
+// event_manager_t::event_memory ============================================
+
+std::size_t event_manager_t::event_memory() const
+{
+  std::size_t bytes = 0;
+  for ( const auto& size_class : event_size_classes )
+  {
+    bytes += size_class.bytes;
+  }
+
+  return bytes;
 }
 
 // event_manager_t::add_event ===============================================
@@ -193,60 +326,47 @@ void event_manager_t::add_event( event_t* e, timespan_t delta_time )
   if ( delta_time < timespan_t::zero() )
     delta_time = timespan_t::zero();
 
-  if ( delta_time > wheel_time )
-  {
-    e->time = current_time + wheel_time - timespan_t::from_seconds( 1 );
-    e->reschedule_time = current_time + delta_time;
-  }
-  else
+  e->time            = current_time + delta_time;
+  e->reschedule_time = timespan_t::zero();
+
+  // Events beyond the reach of the top wheel level are parked at the last
+  // reachable top level slot, and rescheduled from there.
+  unsigned top_shift = wheel_shift * ( wheel_levels - 1 );
+  uint64_t top_distance = ( static_cast<uint64_t>( e->time.total_millis() ) >> top_shift ) -
+                          ( wheel_cursor >> top_shift );
+  if ( top_distance > static_cast<uint64_t>( wheel_mask ) )
   {
-    e->time            = current_time + delta_time;
-    e->reschedule_time = timespan_t::zero();
+    uint64_t park = ( ( wheel_cursor >> top_shift ) + wheel_mask ) << top_shift;
+    e->reschedule_time = e->time;
+    e->time            = timespan_t::from_millis( park );
   }
 
-  // Determine the timing wheel position to which the event will belong
-  // Only valid for integer based timespan_t
-  uint32_t slice = static_cast<uint32_t>(
-      ( e->time.total_millis() >> wheel_shift ) & wheel_mask );
-
-  // Insert event into the event list at the appropriate time
-  event_t** prev = &( timing_wheel[ slice ] );
-#ifdef EVENT_QUEUE_DEBUG
-  unsigned traversed = 0;
-#endif
+  unsigned level = wheel_insert( e );
 
-  while ( ( *prev ) &&
-          ( *prev )->time <= e->time )  // Find position in the list
-  {
-    prev = &( ( *prev )->next );
-#ifdef EVENT_QUEUE_DEBUG
-    traversed++;
-#endif
-  }
 #ifdef EVENT_QUEUE_DEBUG
+  // The wheel level at which an event is filed is the number of cascades it
+  // will go through before execution, the analogue of the list traversal depth
+  // of the old single level wheel. Inserts behind other events in the same
+  // slot are counted as tail inserts.
   events_added++;
-  events_traversed += traversed;
-  if ( traversed > max_queue_depth )
+  if ( level > max_queue_depth )
   {
-    max_queue_depth = traversed;
+    max_queue_depth = level;
   }
-  if ( traversed >= event_queue_depth_samples.size() )
+  if ( level >= event_queue_depth_samples.size() )
   {
-    event_queue_depth_samples.resize( traversed + 1 );
+    event_queue_depth_samples.resize( level + 1 );
   }
-  event_queue_depth_samples[ traversed ].first++;
-  if ( !(*prev) )
+  event_queue_depth_samples[ level ].first++;
+  if ( e != timing_wheel[ level ].head[ ( static_cast<uint64_t>( e->time.total_millis() ) >>
+                                          ( wheel_shift * level ) ) & wheel_mask ] )
   {
-    event_queue_depth_samples[ traversed ].second++;
-    if ( traversed )
-    {
-      n_end_insert++;
-    }
+    event_queue_depth_samples[ level ].second++;
+    n_end_insert++;
   }
+#else
+  (void)level;
 #endif
-  // insert event
-  e->next = *prev;
-  *prev   = e;
 
   if ( ++events_remaining > max_events_remaining )
     max_events_remaining = events_remaining;
@@ -264,6 +384,40 @@ void event_manager_t::add_event( event_t* e, timespan_t delta_time )
 #endif
 }
 
+// event_manager_t::wheel_insert ============================================
+
+unsigned event_manager_t::wheel_insert( event_t* e )
+{
+  uint64_t t = static_cast<uint64_t>( e->time.total_millis() );
+  assert( t >= wheel_cursor );
+
+  // File the event at the lowest level where all higher digits of its time
+  // match the cursor.
+  unsigned level = 0;
+  while ( level + 1 < as<unsigned>( wheel_levels ) &&
+          ( t >> ( wheel_shift * ( level + 1 ) ) ) != ( wheel_cursor >> ( wheel_shift * ( level + 1 ) ) ) )
+  {
+    level++;
+  }
+
+  wheel_level_t& l = timing_wheel[ level ];
+  unsigned slot = static_cast<unsigned>( ( t >> ( wheel_shift * level ) ) & wheel_mask );
+
+  e->next = nullptr;
+  if ( l.tail[ slot ] )
+  {
+    l.tail[ slot ]->next = e;
+  }
+  else
+  {
+    l.head[ slot ] = e;
+    l.occupied[ slot / 64 ] |= uint64_t( 1 ) << ( slot % 64 );
+  }
+  l.tail[ slot ] = e;
+
+  return level;
+}
+
 // event_manager_t::reschedule_event ========================================
 
 void event_manager_t::reschedule_event( event_t* e )
@@ -327,6 +481,10 @@ bool event_manager_t::execute()
         e->execute();
         sw.accumulate();
       }
+      else if ( sim->cpu_profile.sample_event() )
+      {
+        sim->cpu_profile.execute( e );
+      }
       else
       {
         e->execute();
@@ -362,48 +520,72 @@ void event_manager_t::cancel()
 
 void event_manager_t::flush()
 {
-  for ( auto e : allocated_events )
+  for ( const auto& slab : event_slabs )
   {
-    if ( e->recycled )
-      continue;
-    event_t* null_e = e;  // necessary evil
+    std::size_t block_size = event_size_class_bytes( slab.size_class );
+    for ( unsigned i = 0; i < slab.n_blocks; ++i )
+    {
+      event_t* e = reinterpret_cast<event_t*>( slab.data + block_size * i + EVENT_HEADER_SIZE );
+      if ( e->recycled )
+        continue;
+      event_t* null_e = e;  // necessary evil
+      event_t::cancel( null_e );
+      recycle_event( e );
+    }
+  }
+
+  while ( !oversized_events.empty() )
+  {
+    event_t* e = oversized_events.back();
+    event_t* null_e = e;
     event_t::cancel( null_e );
     recycle_event( e );
   }
 
   // Clear Timing Wheel
-  timing_wheel.assign( timing_wheel.size(), nullptr );
+  for ( auto& level : timing_wheel )
+  {
+    range::fill( level.head, nullptr );
+    range::fill( level.tail, nullptr );
+    range::fill( level.occupied, 0 );
+  }
 }
 
 // event_manager_t::init ====================================================
 
 void event_manager_t::init()
 {
-  // Timing wheel depth defaults to about 17 minutes with a granularity of 32
-  // buckets per second.
-  // This makes wheel_size = 32K and it's fully used.
+  // The timing wheel horizon defaults to about 17 minutes, with 256 slots per
+  // level. Level 0 has a granularity of 1ms, so three levels are needed to
+  // reach the default horizon.
   if ( wheel_seconds < 1024 )
     wheel_seconds = 1024;  // 2^10 Min to ensure limited wrap-around
   if ( wheel_granularity <= 0 )
-    wheel_granularity = 32;  // 2^5 Time slices per second
+    wheel_granularity = 32;  // Unused, kept for option compatibility
+  // At least one bitmap word per level, and small enough for a sane memory use
+  wheel_shift = clamp( wheel_shift, 6, 16 );
 
   wheel_time = timespan_t::from_seconds( wheel_seconds );
 
-  // Only valid for integer based timespan_t
-  wheel_size = ( uint32_t )( wheel_time.total_millis() >> wheel_shift );
+  unsigned wheel_size = 1U << wheel_shift;
+  wheel_mask = as<int>( wheel_size - 1 );
 
-  // Round up the wheel depth to the nearest power of 2 to enable a fast "mod"
-  // operation.
-  for ( wheel_mask = 2; wheel_mask < wheel_size; wheel_mask *= 2 )
+  // Enough levels so that an event wheel_time in the future always fits in the
+  // top level without wrapping around.
+  uint64_t horizon = static_cast<uint64_t>( wheel_time.total_millis() );
+  for ( wheel_levels = 1; ( static_cast<uint64_t>( wheel_mask ) << ( wheel_shift * ( wheel_levels - 1 ) ) ) < horizon;
+        wheel_levels++ )
   {
     continue;
   }
-  wheel_size = wheel_mask;
-  wheel_mask--;
 
-  // The timing wheel represents an array of event lists: Each time slice has an
-  // event list.
-  timing_wheel.resize( wheel_size );
+  timing_wheel.resize( wheel_levels );
+  for ( auto& level : timing_wheel )
+  {
+    level.head.assign( wheel_size, nullptr );
+    level.tail.assign( wheel_size, nullptr );
+    level.occupied.assign( wheel_size / 64, 0 );
+  }
 }
 
 // event_manager_t::next_event ==============================================
@@ -415,25 +597,77 @@ event_t* event_manager_t::next_event()
 
   while ( true )
   {
-    event_t*& event_list = timing_wheel[ timing_slice ];
-    if ( event_list )
+    wheel_level_t& l = timing_wheel[ 0 ];
+    int slot = find_occupied_slot( l, static_cast<unsigned>( wheel_cursor & wheel_mask ) );
+    if ( slot >= 0 )
     {
-      event_t* e = event_list;
-      event_list = e->next;
+      wheel_cursor = ( wheel_cursor & ~static_cast<uint64_t>( wheel_mask ) ) | as<unsigned>( slot );
+
+      event_t* e = l.head[ slot ];
+      l.head[ slot ] = e->next;
+      if ( !e->next )
+      {
+        l.tail[ slot ] = nullptr;
+        l.occupied[ slot / 64 ] &= ~( uint64_t( 1 ) << ( slot % 64 ) );
+      }
+      e->next = nullptr;
+
       events_remaining--;
       events_processed++;
       return e;
     }
 
-    timing_slice++;
-    if ( timing_slice == timing_wheel.size() )
+    // Nothing left in the current level 0 revolution
+    wheel_advance();
+  }
+}
+
+// event_manager_t::wheel_advance ===========================================
+
+void event_manager_t::wheel_advance()
+{
+  // Move the cursor to the next occupied slot of the lowest level that still
+  // has events, and cascade that slot down to the lower (now empty) levels.
+  for ( unsigned level = 1; level < as<unsigned>( wheel_levels ); ++level )
+  {
+    unsigned shift = wheel_shift * level;
+    unsigned current = static_cast<unsigned>( ( wheel_cursor >> shift ) & wheel_mask );
+    uint64_t upper = wheel_cursor >> ( shift + wheel_shift );
+    wheel_level_t& l = timing_wheel[ level ];
+
+    int slot = find_occupied_slot( l, current + 1 );
+    // The top level has no level above it to hold later events, so it wraps
+    // around into the next revolution.
+    if ( slot < 0 && level + 1 == as<unsigned>( wheel_levels ) )
     {
-      timing_slice = 0;
-      // Time Wheel turns around.
+      slot = find_occupied_slot( l, 0 );
+      upper++;
     }
+
+    if ( slot < 0 )
+      continue;
+
+    wheel_cursor = ( upper << ( shift + wheel_shift ) ) | ( static_cast<uint64_t>( slot ) << shift );
+
+    event_t* e = l.head[ slot ];
+    l.head[ slot ] = nullptr;
+    l.tail[ slot ] = nullptr;
+    l.occupied[ slot / 64 ] &= ~( uint64_t( 1 ) << ( slot % 64 ) );
+
+    // Cascade, keeping the insertion order of the slot
+    while ( e )
+    {
+      event_t* next = e->next;
+      wheel_insert( e );
+#ifdef EVENT_QUEUE_DEBUG
+      events_traversed++;
+#endif
+      e = next;
+    }
+    return;
   }
 
-  return nullptr;
+  assert( false && "Timing wheel is empty with events remaining" );
 }
 
 // event_manager_t::reset ===================================================
@@ -442,7 +676,7 @@ void event_manager_t::reset()
 {
   events_remaining = 0;
   events_processed = 0;
-  timing_slice     = 0;
+  wheel_cursor     = 0;
   global_event_id  = 0;
   canceled         = false;
   current_time     = timespan_t::zero();
@@ -455,6 +689,17 @@ void event_manager_t::merge( event_manager_t& other )
   max_events_remaining =
       std::max( max_events_remaining, other.max_events_remaining );
   total_events_processed += other.total_events_processed;
+
+  for ( unsigned i = 0; i < N_EVENT_SIZE_CLASSES; ++i )
+  {
+    auto& size_class = event_size_classes[ i ];
+    const auto& other_size_class = other.event_size_classes[ i ];
+    size_class.peak_live = std::max( size_class.peak_live, other_size_class.peak_live );
+    size_class.n_allocations += other_size_class.n_allocations;
+    size_class.bytes += other_size_class.bytes;
+  }
+  oversized_peak_live = std::max( oversized_peak_live, other.oversized_peak_live );
+  oversized_allocations += other.oversized_allocations;
 #ifdef EVENT_QUEUE_DEBUG
   events_traversed += other.events_traversed;
   events_added += other.events_added;
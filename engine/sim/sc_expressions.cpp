@@ -15,17 +15,26 @@ namespace
 constexpr bool EXPRESSION_DEBUG = false;
 // Unary Operators ==========================================================
 
-template <class F>
-class expr_unary_t : public expr_t
+class unary_base_t : public expr_t
 {
+public:
   std::unique_ptr<expr_t> input;
 
-public:
-  expr_unary_t( const std::string& n, token_e o, std::unique_ptr<expr_t> i )
+  unary_base_t( const std::string& n, token_e o, std::unique_ptr<expr_t> i )
     : expr_t( n, o ), input( std::move(i) )
   {
     assert(input);
   }
+};
+
+template <class F>
+class expr_unary_t : public unary_base_t
+{
+public:
+  expr_unary_t( const std::string& n, token_e o, std::unique_ptr<expr_t> i )
+    : unary_base_t( n, o, std::move(i) )
+  {
+  }
 
   double evaluate() override  // override
   {
@@ -119,6 +128,21 @@ public:
   }
 };
 
+// Binary operator with one operand reduced to a constant by the optimizer
+class reduced_binary_base_t : public expr_t
+{
+public:
+  std::unique_ptr<expr_t> operand;
+  double value;
+  bool value_left;
+
+  reduced_binary_base_t( const std::string& n, token_e o, std::unique_ptr<expr_t> e, double v, bool left )
+    : expr_t( n, o ), operand( std::move(e) ), value( v ), value_left( left )
+  {
+    assert(operand);
+  }
+};
+
 class logical_and_t : public binary_base_t
 {
 public:
@@ -673,17 +697,15 @@ public:
         printf("Reduced %*d %s (%s) binary expression left\n", spacing, id(),
           name(), left->name());
       }
-      struct left_reduced_t : public expr_t
+      struct left_reduced_t : public reduced_binary_base_t
       {
-        double left;
-        std::unique_ptr<expr_t> right;
         left_reduced_t( const std::string& n, token_e o, double l, std::unique_ptr<expr_t> r )
-          : expr_t( n, o ), left( l ), right( std::move(r) )
+          : reduced_binary_base_t( n, o, std::move(r), l, true )
         {
         }
         double evaluate() override
         {
-          return F<double>()( left, right->eval() );
+          return F<double>()( value, operand->eval() );
         }
       };
       return std::make_unique<left_reduced_t>(
@@ -695,17 +717,15 @@ public:
       if ( EXPRESSION_DEBUG )
         printf( "Reduced %*d %s (%s) binary expression right\n", spacing, id(),
                 name(), right->name() );
-      struct right_reduced_t : public expr_t
+      struct right_reduced_t : public reduced_binary_base_t
       {
-        std::unique_ptr<expr_t> left;
-        double right;
         right_reduced_t( const std::string& n, token_e o, std::unique_ptr<expr_t> l, double r )
-          : expr_t( n, o ), left( std::move(l) ), right( r )
+          : reduced_binary_base_t( n, o, std::move(l), r, false )
         {
         }
         double evaluate() override
         {
-          return F<double>()( left->eval(), right );
+          return F<double>()( operand->eval(), value );
         }
       };
       return std::make_unique<right_reduced_t>(
@@ -761,6 +781,377 @@ std::unique_ptr<expr_t> select_analyze_binary( const std::string& name, token_e
   }
 }
 
+// Compiled Expressions =====================================================
+
+// Optimized expression trees are lowered into a flat program for a small stack machine. Operator
+// nodes become opcodes, constant subtrees are folded into the constant pool, and logical and/or
+// short-circuit with conditional jumps. Everything else (i.e., the actual state queries) is an
+// opaque leaf, evaluated through its own expr_t::eval().
+
+enum opcode_e : uint8_t
+{
+  OP_CONST = 0, // Push constants[ arg ]
+  OP_LEAF,      // Push leaves[ arg ]->eval()
+  OP_NEG,
+  OP_NOT,
+  OP_ABS,
+  OP_FLOOR,
+  OP_CEIL,
+  OP_ADD,
+  OP_SUB,
+  OP_MULT,
+  OP_DIV,
+  OP_MAX,
+  OP_MIN,
+  OP_EQ,
+  OP_NOTEQ,
+  OP_LT,
+  OP_LTEQ,
+  OP_GT,
+  OP_GTEQ,
+  OP_XOR,
+  OP_BOOL,      // Normalize top of stack to 0/1
+  OP_AND_JUMP,  // If top is false, replace it with 0 and jump to arg, otherwise pop it
+  OP_OR_JUMP    // If top is true, replace it with 1 and jump to arg, otherwise pop it
+};
+
+struct instruction_t
+{
+  opcode_e op;
+  uint32_t arg;
+};
+
+// Maximum evaluation stack depth of a compiled expression. Deeper expressions stay as trees.
+constexpr size_t MAX_COMPILED_STACK = 32;
+
+opcode_e unary_opcode( token_e op )
+{
+  switch ( op )
+  {
+    case TOK_MINUS: return OP_NEG;
+    case TOK_NOT:   return OP_NOT;
+    case TOK_ABS:   return OP_ABS;
+    case TOK_FLOOR: return OP_FLOOR;
+    case TOK_CEIL:  return OP_CEIL;
+    default:        return OP_LEAF;
+  }
+}
+
+opcode_e binary_opcode( token_e op )
+{
+  switch ( op )
+  {
+    case TOK_ADD:   return OP_ADD;
+    case TOK_SUB:   return OP_SUB;
+    case TOK_MULT:  return OP_MULT;
+    case TOK_DIV:   return OP_DIV;
+    case TOK_MAX:   return OP_MAX;
+    case TOK_MIN:   return OP_MIN;
+    case TOK_EQ:    return OP_EQ;
+    case TOK_NOTEQ: return OP_NOTEQ;
+    case TOK_LT:    return OP_LT;
+    case TOK_LTEQ:  return OP_LTEQ;
+    case TOK_GT:    return OP_GT;
+    case TOK_GTEQ:  return OP_GTEQ;
+    case TOK_XOR:   return OP_XOR;
+    case TOK_AND:   return OP_AND_JUMP;
+    case TOK_OR:    return OP_OR_JUMP;
+    default:        return OP_LEAF;
+  }
+}
+
+double apply_unary( opcode_e op, double v )
+{
+  switch ( op )
+  {
+    case OP_NEG:   return -v;
+    case OP_NOT:   return v == 0;
+    case OP_ABS:   return std::fabs( v );
+    case OP_FLOOR: return std::floor( v );
+    case OP_CEIL:  return std::ceil( v );
+    default:       assert( false ); return 0;
+  }
+}
+
+double apply_binary( opcode_e op, double l, double r )
+{
+  switch ( op )
+  {
+    case OP_ADD:      return l + r;
+    case OP_SUB:      return l - r;
+    case OP_MULT:     return l * r;
+    case OP_DIV:      return l / r;
+    case OP_MAX:      return std::max( l, r );
+    case OP_MIN:      return std::min( l, r );
+    case OP_EQ:       return l == r;
+    case OP_NOTEQ:    return l != r;
+    case OP_LT:       return l < r;
+    case OP_LTEQ:     return l <= r;
+    case OP_GT:       return l > r;
+    case OP_GTEQ:     return l >= r;
+    case OP_XOR:      return ( l != 0 ) != ( r != 0 );
+    case OP_AND_JUMP: return l != 0 && r != 0;
+    case OP_OR_JUMP:  return l != 0 || r != 0;
+    default:          assert( false ); return 0;
+  }
+}
+
+class compiled_expr_t : public expr_t
+{
+  // The original tree owns the leaves referenced by the program
+  std::unique_ptr<expr_t> tree;
+  std::vector<instruction_t> code;
+  std::vector<double> constants;
+  std::vector<expr_t*> leaves;
+
+public:
+  compiled_expr_t( std::unique_ptr<expr_t> t, std::vector<instruction_t> c, std::vector<double> k,
+                   std::vector<expr_t*> l )
+    : expr_t( fmt::format( "compiled('{}')", t->name() ), t->op_ ),
+      tree( std::move( t ) ), code( std::move( c ) ), constants( std::move( k ) ), leaves( std::move( l ) )
+  {
+  }
+
+  double evaluate() override
+  {
+    // Evaluation stack is local, so leaves may recursively evaluate other (or even this) compiled
+    // expression.
+    std::array<double, MAX_COMPILED_STACK> stack;
+    double* top = stack.data();
+
+    const instruction_t* ip = code.data();
+    const instruction_t* end = ip + code.size();
+
+    while ( ip != end )
+    {
+      switch ( ip->op )
+      {
+        case OP_CONST: *top++ = constants[ ip->arg ]; break;
+        case OP_LEAF:  *top++ = leaves[ ip->arg ]->eval(); break;
+        case OP_NEG:   top[ -1 ] = -top[ -1 ]; break;
+        case OP_NOT:   top[ -1 ] = top[ -1 ] == 0; break;
+        case OP_ABS:   top[ -1 ] = std::fabs( top[ -1 ] ); break;
+        case OP_FLOOR: top[ -1 ] = std::floor( top[ -1 ] ); break;
+        case OP_CEIL:  top[ -1 ] = std::ceil( top[ -1 ] ); break;
+        case OP_ADD:   --top; top[ -1 ] = top[ -1 ] + top[ 0 ]; break;
+        case OP_SUB:   --top; top[ -1 ] = top[ -1 ] - top[ 0 ]; break;
+        case OP_MULT:  --top; top[ -1 ] = top[ -1 ] * top[ 0 ]; break;
+        case OP_DIV:   --top; top[ -1 ] = top[ -1 ] / top[ 0 ]; break;
+        case OP_MAX:   --top; top[ -1 ] = std::max( top[ -1 ], top[ 0 ] ); break;
+        case OP_MIN:   --top; top[ -1 ] = std::min( top[ -1 ], top[ 0 ] ); break;
+        case OP_EQ:    --top; top[ -1 ] = top[ -1 ] == top[ 0 ]; break;
+        case OP_NOTEQ: --top; top[ -1 ] = top[ -1 ] != top[ 0 ]; break;
+        case OP_LT:    --top; top[ -1 ] = top[ -1 ] < top[ 0 ]; break;
+        case OP_LTEQ:  --top; top[ -1 ] = top[ -1 ] <= top[ 0 ]; break;
+        case OP_GT:    --top; top[ -1 ] = top[ -1 ] > top[ 0 ]; break;
+        case OP_GTEQ:  --top; top[ -1 ] = top[ -1 ] >= top[ 0 ]; break;
+        case OP_XOR:   --top; top[ -1 ] = ( top[ -1 ] != 0 ) != ( top[ 0 ] != 0 ); break;
+        case OP_BOOL:  top[ -1 ] = top[ -1 ] != 0; break;
+        case OP_AND_JUMP:
+          if ( top[ -1 ] == 0 )
+          {
+            top[ -1 ] = 0;
+            ip = code.data() + ip->arg;
+            continue;
+          }
+          --top;
+          break;
+        case OP_OR_JUMP:
+          if ( top[ -1 ] != 0 )
+          {
+            top[ -1 ] = 1;
+            ip = code.data() + ip->arg;
+            continue;
+          }
+          --top;
+          break;
+      }
+
+      ++ip;
+    }
+
+    assert( top == stack.data() + 1 );
+    return stack[ 0 ];
+  }
+};
+
+class expr_compiler_t
+{
+  std::vector<instruction_t> code;
+  std::vector<double> constants;
+  std::vector<expr_t*> leaves;
+  size_t depth, max_depth;
+
+  size_t emit( opcode_e op, uint32_t arg, int stack_delta )
+  {
+    code.push_back( { op, arg } );
+    depth += stack_delta;
+    max_depth = std::max( max_depth, depth );
+
+    return code.size() - 1;
+  }
+
+  void emit_constant( double v )
+  {
+    auto it = range::find( constants, v );
+    if ( it == constants.end() )
+    {
+      constants.push_back( v );
+      it = constants.end() - 1;
+    }
+
+    emit( OP_CONST, as<uint32_t>( std::distance( constants.begin(), it ) ), 1 );
+  }
+
+  // Fold operator subtrees whose inputs are all constant
+  bool constant_value( expr_t* e, double& v ) const
+  {
+    if ( e->is_constant( &v ) )
+    {
+      return true;
+    }
+
+    if ( auto u = dynamic_cast<unary_base_t*>( e ) )
+    {
+      auto op = unary_opcode( u->op_ );
+      if ( op == OP_LEAF || ! constant_value( u->input.get(), v ) )
+      {
+        return false;
+      }
+
+      v = apply_unary( op, v );
+      return true;
+    }
+
+    if ( auto b = dynamic_cast<binary_base_t*>( e ) )
+    {
+      double l, r;
+      auto op = binary_opcode( b->op_ );
+      if ( op == OP_LEAF || ! constant_value( b->left.get(), l ) || ! constant_value( b->right.get(), r ) )
+      {
+        return false;
+      }
+
+      v = apply_binary( op, l, r );
+      return true;
+    }
+
+    if ( auto r = dynamic_cast<reduced_binary_base_t*>( e ) )
+    {
+      double o;
+      auto op = binary_opcode( r->op_ );
+      if ( op == OP_LEAF || ! constant_value( r->operand.get(), o ) )
+      {
+        return false;
+      }
+
+      v = r->value_left ? apply_binary( op, r->value, o ) : apply_binary( op, o, r->value );
+      return true;
+    }
+
+    return false;
+  }
+
+  void emit_leaf( expr_t* e )
+  {
+    emit( OP_LEAF, as<uint32_t>( leaves.size() ), 1 );
+    leaves.push_back( e );
+  }
+
+  void compile( expr_t* e )
+  {
+    double v;
+    if ( constant_value( e, v ) )
+    {
+      emit_constant( v );
+    }
+    else if ( auto u = dynamic_cast<unary_base_t*>( e ) )
+    {
+      auto op = unary_opcode( u->op_ );
+      if ( op == OP_LEAF )
+      {
+        emit_leaf( e );
+        return;
+      }
+
+      compile( u->input.get() );
+      emit( op, 0, 0 );
+    }
+    else if ( auto b = dynamic_cast<binary_base_t*>( e ) )
+    {
+      auto op = binary_opcode( b->op_ );
+      if ( op == OP_LEAF )
+      {
+        emit_leaf( e );
+        return;
+      }
+
+      compile( b->left.get() );
+
+      if ( op == OP_AND_JUMP || op == OP_OR_JUMP )
+      {
+        // Taken jump leaves the (normalized) left result on the stack, fallthrough pops it
+        auto jump = emit( op, 0, -1 );
+        compile( b->right.get() );
+        emit( OP_BOOL, 0, 0 );
+        code[ jump ].arg = as<uint32_t>( code.size() );
+      }
+      else
+      {
+        compile( b->right.get() );
+        emit( op, 0, -1 );
+      }
+    }
+    else if ( auto r = dynamic_cast<reduced_binary_base_t*>( e ) )
+    {
+      auto op = binary_opcode( r->op_ );
+      // The optimizer never reduces logical operators, they are folded away completely instead
+      if ( op == OP_LEAF || op == OP_AND_JUMP || op == OP_OR_JUMP )
+      {
+        emit_leaf( e );
+        return;
+      }
+
+      if ( r->value_left )
+      {
+        emit_constant( r->value );
+        compile( r->operand.get() );
+      }
+      else
+      {
+        compile( r->operand.get() );
+        emit_constant( r->value );
+      }
+
+      emit( op, 0, -1 );
+    }
+    else
+    {
+      emit_leaf( e );
+    }
+  }
+
+public:
+  expr_compiler_t() : depth( 0 ), max_depth( 0 )
+  { }
+
+  // Returns a compiled version of the expression tree (taking ownership of it), or nullptr if
+  // compilation is not worthwhile, in which case the tree is left untouched.
+  std::unique_ptr<expr_t> build( std::unique_ptr<expr_t>& tree )
+  {
+    compile( tree.get() );
+
+    // Single constants or leaves gain nothing from the interpreter loop
+    if ( code.size() < 2 || max_depth > MAX_COMPILED_STACK )
+    {
+      return {};
+    }
+
+    return std::make_unique<compiled_expr_t>( std::move( tree ), std::move( code ),
+                                              std::move( constants ), std::move( leaves ) );
+  }
+};
+
 }  // UNNAMED NAMESPACE ====================================================
 
 // precedence ===============================================================
@@ -1333,6 +1724,22 @@ std::unique_ptr<expr_t> expr_t::parse( action_t* action, const std::string& expr
   }
 }
 
+// expr_t::compile_expression ===============================================
+
+void expr_t::compile_expression( std::unique_ptr<expr_t>& expression )
+{
+  if ( !expression )
+  {
+    return;
+  }
+
+  expression::expr_compiler_t compiler;
+  if ( auto compiled = compiler.build( expression ) )
+  {
+    expression = std::move( compiled );
+  }
+}
+
 #ifdef UNIT_TEST
 
 uint32_t dbc::get_school_mask( school_e )
@@ -1359,14 +1766,23 @@ expr_t* parse_expression( const char* arg )
   return 0;
 }
 
-void time_test( expr_t* expr, uint64_t n )
+void time_test( expr_t* expr, uint64_t n, const char* label = "evaluate" )
 {
   double value        = 0;
   const int64_t start = util::milliseconds();
   for ( uint64_t i = 0; i < n; ++i )
     value            = expr->eval();
   const int64_t stop = util::milliseconds();
-  printf( "evaluate: %f in %.4f seconds\n", value, ( stop - start ) / 1000.0 );
+  printf( "%s: %f in %.4f seconds\n", label, value, ( stop - start ) / 1000.0 );
+}
+
+// Benchmark the tree evaluation against the compiled form of the same expression
+void compile_test( expr_t* expr, uint64_t n )
+{
+  std::unique_ptr<expr_t> tree( expr );
+  time_test( tree.get(), n, "tree" );
+  expr_t::compile_expression( tree );
+  time_test( tree.get(), n, "compiled" );
 }
 }
 
@@ -1416,7 +1832,7 @@ int main( int argc, char** argv )
         printf( "%f\n", expr->eval() );
       }
       else
-        time_test( expr, n_evals );
+        compile_test( expr, n_evals );
     }
   }
 
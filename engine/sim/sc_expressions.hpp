@@ -158,6 +158,11 @@ public:
     }
   }
 
+  /* Lowers the (optimized) expression into a flat program evaluated by a stack machine, in
+  place. Expressions that do not benefit from compilation are left as is.
+  */
+  static void compile_expression( std::unique_ptr<expr_t>& expression );
+
   virtual double evaluate() = 0;
 
   virtual bool is_constant( double* /*return_value*/ )
@@ -264,6 +269,36 @@ struct target_wrapper_expr_t : public expr_t
   double evaluate() override;
 };
 
+// Expression value cache - expr_epoch_cache_t
+// Memoizes a value for as long as the simulated time and the state epoch of the object the value
+// was computed from stay the same. Objects (buffs, cooldowns) increment their epoch on every state
+// change, so repeated queries of the same object at the same timestamp (e.g., several action lines
+// asking for buff.X.up during one action list scan) are only computed once.
+class expr_epoch_cache_t
+{
+  timespan_t time;
+  uint64_t epoch;
+  double value;
+
+public:
+  expr_epoch_cache_t() : time( timespan_t::min() ), epoch( 0 ), value( 0 )
+  {
+  }
+
+  template <typename F>
+  double get( timespan_t now, uint64_t current_epoch, F&& f )
+  {
+    if ( now != time || current_epoch != epoch )
+    {
+      value = expr_t::coerce( f() );
+      time  = now;
+      epoch = current_epoch;
+    }
+
+    return value;
+  }
+};
+
 // Template to return a function expression
 template <typename F>
 inline std::unique_ptr<expr_t> make_fn_expr( const std::string& name, F&& f )
@@ -0,0 +1,104 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "simulationcraft.hpp"
+
+// init_profile_t::timer_t ==================================================
+
+init_profile_t::timer_t::timer_t( init_profile_t& p, const player_t* a, const char* phase ) :
+  profile( p.enabled ? &p : nullptr ), actor( a )
+{
+  if ( phase )
+  {
+    next( phase );
+  }
+}
+
+init_profile_t::timer_t::~timer_t()
+{
+  stop();
+}
+
+void init_profile_t::timer_t::next( const char* p )
+{
+  if ( ! profile )
+  {
+    return;
+  }
+
+  stop();
+  phase = p;
+  start = std::chrono::high_resolution_clock::now();
+}
+
+void init_profile_t::timer_t::stop()
+{
+  if ( ! profile || phase.empty() )
+  {
+    return;
+  }
+
+  profile -> add( actor, phase, util::duration_fp_seconds( start ) );
+  phase.clear();
+}
+
+// init_profile_t =========================================================
+
+void init_profile_t::add( const player_t* actor, const std::string& phase, double time )
+{
+  entry_t entry;
+  if ( actor )
+  {
+    const player_t* module_actor = actor -> is_pet() ? actor -> cast_pet() -> owner : actor;
+    entry.actor = actor -> name_str;
+    entry.group = util::player_type_string( module_actor -> type );
+  }
+  else
+  {
+    entry.group = "sim";
+  }
+  entry.phase = phase;
+  entry.time = time;
+  entry.count = 1;
+
+  add( entry );
+}
+
+void init_profile_t::add( const entry_t& entry )
+{
+  auto it = index.emplace( entry.actor + '\0' + entry.phase, entries.size() );
+  if ( it.second )
+  {
+    entries.push_back( entry );
+  }
+  else
+  {
+    entries[ it.first -> second ].time += entry.time;
+    entries[ it.first -> second ].count += entry.count;
+  }
+}
+
+void init_profile_t::merge( const init_profile_t& other )
+{
+  range::for_each( other.entries, [ this ]( const entry_t& entry ) { add( entry ); } );
+}
+
+void init_profile_t::merge_groups( const init_profile_t& other )
+{
+  for ( const auto& entry : other.entries )
+  {
+    entry_t group_entry = entry;
+    group_entry.actor = entry.actor.empty() ? std::string() : entry.group;
+    add( group_entry );
+  }
+}
+
+std::vector<const init_profile_t::entry_t*> init_profile_t::sorted() const
+{
+  std::vector<const entry_t*> out;
+  range::for_each( entries, [ &out ]( const entry_t& entry ) { out.push_back( &entry ); } );
+  range::sort( out, []( const entry_t* l, const entry_t* r ) { return l -> time > r -> time; } );
+  return out;
+}
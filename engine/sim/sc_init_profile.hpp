@@ -0,0 +1,65 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+#ifndef SC_INIT_PROFILE_HPP
+#define SC_INIT_PROFILE_HPP
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct player_t;
+
+/**
+ * Wall time spent in the phases of sim and actor initialization, collected with init_profile=1.
+ * Entries are keyed by actor (empty for the sim itself) and phase. Nested phases are named
+ * "<phase>/<part>", their time is also included in the parent phase.
+ */
+struct init_profile_t
+{
+  struct entry_t
+  {
+    std::string actor;
+    std::string group; // Class module of the actor, used to aggregate profilesets
+    std::string phase;
+    double time;
+    unsigned count;
+  };
+
+  // Times consecutive phases, starting a phase ends the previous one. Phase names are only copied
+  // when the profile is enabled, callers building names should check enabled first.
+  struct timer_t
+  {
+    init_profile_t* profile;
+    const player_t* actor;
+    std::string phase;
+    std::chrono::high_resolution_clock::time_point start;
+
+    timer_t( init_profile_t& profile, const player_t* actor = nullptr, const char* phase = nullptr );
+    ~timer_t();
+    void next( const char* phase );
+    void next( const std::string& phase )
+    { next( phase.c_str() ); }
+    void stop();
+  };
+
+  bool enabled;
+  std::vector<entry_t> entries;
+  std::unordered_map<std::string, size_t> index;
+
+  init_profile_t() : enabled( false )
+  { }
+
+  void add( const player_t* actor, const std::string& phase, double time );
+  void add( const entry_t& entry );
+  /// Merge entries of the same actor, e.g. from the sims of other threads
+  void merge( const init_profile_t& other );
+  /// Merge entries of the same class module, e.g. from profileset sims
+  void merge_groups( const init_profile_t& other );
+  /// Entries by descending time
+  std::vector<const entry_t*> sorted() const;
+};
+
+#endif /* SC_INIT_PROFILE_HPP */
@@ -8,6 +8,12 @@
 
 #ifndef SC_NO_THREADING
 
+#include "interfaces/sc_js.hpp"
+#include "report/sc_report.hpp"
+#include "util/git_info.hpp"
+#include "util/io.hpp"
+
+#include <cstdio>
 #include <future>
 #include <memory>
 
@@ -29,6 +35,109 @@ bool overridable_option( const option_tuple_t& tuple )
          tuple.name.rfind( "raid_events", 0 ) == std::string::npos;
 }
 
+// 64-bit FNV-1a, used to name result cache entries. Collisions are detected by comparing the
+// full key stored in the entry.
+// Object members with the given names all satisfy the type check
+template <typename Check>
+bool has_members( const rapidjson::Value& v, std::initializer_list<const char*> names, Check check )
+{
+  return v.IsObject() && std::all_of( names.begin(), names.end(), [ &v, &check ]( const char* name ) {
+    return v.HasMember( name ) && check( v[ name ] );
+  } );
+}
+
+bool is_number( const rapidjson::Value& v )
+{ return v.IsNumber(); }
+
+bool is_string( const rapidjson::Value& v )
+{ return v.IsString(); }
+
+bool is_uint( const rapidjson::Value& v )
+{ return v.IsUint(); }
+
+// Check the structure of a result cache entry before anything is read from it, so truncated or
+// otherwise corrupt entries are treated as cache misses
+bool valid_cache_entry( const rapidjson::Document& doc )
+{
+  if ( ! doc.IsObject() || ! doc.HasMember( "key" ) || ! doc[ "key" ].IsString() ||
+       ! doc.HasMember( "results" ) || ! doc[ "results" ].IsArray() )
+  {
+    return false;
+  }
+
+  for ( const auto& v : doc[ "results" ].GetArray() )
+  {
+    if ( ! has_members( v, { "mean", "median", "min", "max", "first_quartile", "third_quartile",
+                             "stddev", "mean_stddev" }, is_number ) ||
+         ! v.HasMember( "metric" ) || ! v[ "metric" ].IsInt() ||
+         ! v.HasMember( "iterations" ) || ! v[ "iterations" ].IsUint64() )
+    {
+      return false;
+    }
+  }
+
+  if ( ! doc.HasMember( "output_data" ) )
+  {
+    return true;
+  }
+
+  const auto& v = doc[ "output_data" ];
+  if ( ! v.IsObject() || ! v.HasMember( "race" ) || ! v[ "race" ].IsInt() ||
+       ! v.HasMember( "ptr" ) || ! v[ "ptr" ].IsBool() ||
+       ! has_members( v, { "artifact", "crucible" }, is_string ) ||
+       ! v.HasMember( "gear" ) || ! v[ "gear" ].IsArray() ||
+       ! has_members( v, { "stats" }, []( const rapidjson::Value& stats ) { return stats.IsObject(); } ) )
+  {
+    return false;
+  }
+
+  if ( v.HasMember( "talents" ) &&
+       ( ! v[ "talents" ].IsArray() || ! std::all_of( v[ "talents" ].Begin(), v[ "talents" ].End(), is_uint ) ) )
+  {
+    return false;
+  }
+
+  for ( const auto& item : v[ "gear" ].GetArray() )
+  {
+    if ( ! has_members( item, { "slot" }, is_string ) ||
+         ! has_members( item, { "item_id", "item_level" }, is_uint ) )
+    {
+      return false;
+    }
+  }
+
+  return has_members( v[ "stats" ], { "crit_rating", "crit_pct", "haste_rating", "haste_pct",
+                                      "mastery_rating", "mastery_pct", "versatility_rating",
+                                      "versatility_pct", "agility", "strength", "intellect", "stamina",
+                                      "avoidance_rating", "avoidance_pct", "leech_rating", "leech_pct",
+                                      "speed_rating", "speed_pct", "corruption",
+                                      "corruption_resistance" }, is_number );
+}
+
+uint64_t fnv1a_64( const std::string& str )
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for ( auto c : str )
+  {
+    hash ^= static_cast<unsigned char>( c );
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+std::string trim( const std::string& str )
+{
+  auto first = str.find_first_not_of( " \t\r\n" );
+  if ( first == std::string::npos )
+  {
+    return std::string();
+  }
+
+  auto last = str.find_last_not_of( " \t\r\n" );
+  return str.substr( first, last - first + 1 );
+}
+
 std::string format_time( double seconds, bool milliseconds = true )
 {
   std::stringstream s;
@@ -90,10 +199,34 @@ std::string format_time( double seconds, bool milliseconds = true )
 
 // Deallocating profile_sim is the responsibility of the caller (i.e., profileset driver or
 // worker_t)
-void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*& profile_sim )
+//
+// Every profileset is simulated by a newly constructed and initialized sim. Profileset options can
+// change any part of an actor definition and actor initialization is one-shot, so sims and actors
+// are not kept warm across profilesets. Only the threads running them are reused (see the thread
+// pool in util/concurrency.cpp).
+void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*& profile_sim, double setup_time )
 {
   // Reset random seed for the profileset sims
   profile_sim -> seed = 0;
+  // Racing rounds only simulate the iterations they add to the earlier rounds. Deterministic rounds
+  // after the first need a seed of their own, or they would repeat the iterations of the first one.
+  if ( set.race_rounds() > 0 )
+  {
+    if ( profile_sim -> deterministic && set.race_iterations_done() > 0 )
+    {
+      profile_sim -> seed = set.race_rounds();
+    }
+
+    if ( set.race_iterations() > 0 )
+    {
+      profile_sim -> iterations = std::max( 1, set.race_iterations() - set.race_iterations_done() );
+      profile_sim -> target_error = 0;
+    }
+    else if ( profile_sim -> target_error <= 0 )
+    {
+      profile_sim -> iterations = std::max( 1, profile_sim -> iterations - set.race_iterations_done() );
+    }
+  }
   profile_sim -> profileset_enabled = true;
   profile_sim -> report_details = 0;
   if ( parent -> profileset_work_threads > 0 )
@@ -128,8 +261,31 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
   const auto player = profile_sim -> player_no_pet_list.data().front();
   auto progress = profile_sim -> progress( nullptr, 0 );
 
+  // Iteration wall time is bounded by the slowest thread, everything else in the profileset
+  // simulation is setup and teardown overhead.
+  auto simulate_time = profile_sim -> run_time;
+  range::for_each( profile_sim -> run_time_per_thread, [ &simulate_time ]( double t ) {
+    simulate_time = std::max( simulate_time, t );
+  } );
+  set.add_timing( setup_time + std::max( 0.0, profile_sim -> elapsed_time - simulate_time ), simulate_time );
+
+  if ( ! profile_sim -> init_profile.entries.empty() )
+  {
+    parent -> profilesets.add_init_profile( profile_sim -> init_profile );
+  }
+
+  if ( set.race_rounds() > 0 )
+  {
+    set.add_race_iterations( progress.current_iterations );
+  }
+
   range::for_each( parent -> profileset_metric, [ & ]( scale_metric_e metric ) {
-    auto data = profileset::metric_data( player, metric );
+    auto samples = profileset::metric_samples( player, metric );
+    if ( set.race_rounds() > 0 )
+    {
+      samples = set.add_race_samples( metric, samples );
+    }
+    auto data = profileset::metric_data( samples );
 
     set.result( metric )
       .min( data.min )
@@ -140,7 +296,7 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
       .max( data.max )
       .stddev( data.std_dev )
       .mean_stddev( data.mean_std_dev )
-      .iterations( progress.current_iterations );
+      .iterations( set.race_rounds() > 0 ? set.race_iterations_done() : progress.current_iterations );
   } );
 
   if ( ! parent -> profileset_output_data.empty() )
@@ -158,7 +314,13 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
   parent -> analyze_time += profile_sim -> analyze_time;
   parent -> event_mgr.total_events_processed += profile_sim -> event_mgr.total_events_processed;
 
-  set.cleanup_options();
+  parent -> profilesets.cache().store( parent, set );
+
+  // Racing mode may simulate the set again, options are cleaned up once racing is done
+  if ( ! parent -> profilesets.racing( parent ) )
+  {
+    set.cleanup_options();
+  }
 }
 
 void insert_data( highchart::bar_chart_t& chart,
@@ -376,7 +538,9 @@ sim_control_t* profilesets_t::create_sim_options( const sim_control_t*
 }
 
 profile_set_t::profile_set_t( const std::string& name, sim_control_t* opts, bool has_output ) :
-  m_name( name ), m_options( opts ), m_has_output( has_output ), m_output_data( nullptr )
+  m_name( name ), m_options( opts ), m_has_output( has_output ), m_output_data( nullptr ),
+  m_init_time( 0 ), m_simulate_time( 0 ), m_race_iterations( 0 ), m_race_rounds( 0 ),
+  m_race_iterations_done( 0 ), m_eliminated( false )
 {
 }
 
@@ -396,6 +560,37 @@ profile_set_t::~profile_set_t()
   delete m_options;
 }
 
+std::vector<const extended_sample_data_t*> profile_set_t::add_race_samples(
+    scale_metric_e metric, const std::vector<const extended_sample_data_t*>& samples )
+{
+  auto it = range::find_if( m_race_samples,
+      [ metric ]( const std::pair<scale_metric_e, std::vector<extended_sample_data_t>>& entry ) {
+    return entry.first == metric;
+  } );
+
+  if ( it == m_race_samples.end() )
+  {
+    m_race_samples.emplace_back( metric, std::vector<extended_sample_data_t>() );
+    it = m_race_samples.end() - 1;
+    range::for_each( samples, [ it ]( const extended_sample_data_t* data ) { it -> second.push_back( *data ); } );
+  }
+  else
+  {
+    for ( size_t i = 0; i < samples.size(); ++i )
+    {
+      it -> second[ i ].merge( *samples[ i ] );
+    }
+  }
+
+  std::vector<const extended_sample_data_t*> merged;
+  range::for_each( it -> second, [ &merged ]( extended_sample_data_t& data ) {
+    data.analyze();
+    merged.push_back( &data );
+  } );
+
+  return merged;
+}
+
 const profile_result_t& profile_set_t::result( scale_metric_e metric ) const
 {
   static const profile_result_t __default {};
@@ -440,27 +635,393 @@ profile_result_t& profile_set_t::result( scale_metric_e metric )
   return m_results.back();
 }
 
-worker_t::worker_t( profilesets_t* master, sim_t* p, profile_set_t* ps ) :
-  m_done( false ), m_parent( p ), m_master( master ), m_sim( nullptr ), m_profileset( ps ),
-  m_thread( nullptr )
+std::string result_cache_t::path( const std::string& name ) const
 {
-  m_thread = new std::thread( std::bind( &worker_t::execute, this ) );
+  return m_dir + "/" + name;
 }
 
-worker_t::~worker_t()
+void result_cache_t::initialize( sim_t* sim )
 {
-  delete m_sim;
-  delete m_thread;
+  if ( sim -> profileset_cache_dir.empty() )
+  {
+    return;
+  }
+
+  // Entries are only valid for the engine revision that produced them
+  if ( ! git_info::available() )
+  {
+    sim -> errorf( "Profileset result cache disabled, the engine revision is unknown" );
+    return;
+  }
+
+  m_dir = sim -> profileset_cache_dir;
+  m_max_size = static_cast<uint64_t>( std::max( 0, sim -> profileset_cache_size ) ) * 1024 * 1024;
+  m_refresh = sim -> profileset_cache_refresh;
+
+  // Index lines are "<entry> <size in bytes> <last use>"
+  io::ifstream index;
+  index.open( path( "index" ) );
+  std::string name;
+  entry_t entry;
+  while ( index >> name >> entry.size >> entry.last_use )
+  {
+    m_entries[ name ] = entry;
+    m_size += entry.size;
+    m_clock = std::max( m_clock, entry.last_use );
+  }
+}
+
+// Options that do not change the results of the simulation are left out of the key. Profilesets that
+// write their own reports are not cached, as a cache hit would skip the report. Neither are racing
+// rounds, as their results include the samples of the earlier rounds.
+std::string result_cache_t::key( const sim_t* parent, const profile_set_t& set ) const
+{
+  static const std::vector<std::string> ignored_opts {
+    "threads", "html", "json", "json2", "output", "xml", "report_progress",
+    "profileset_work_threads", "profileset_init_threads", "seed"
+  };
+
+  if ( ! enabled() || set.options() == nullptr || set.has_output() || set.race_rounds() > 0 )
+  {
+    return std::string();
+  }
+
+  // Seed the profileset sim actually runs with. simulate_profileset() resets the seed, so seed
+  // options have no effect, and sim_t::init() seeds deterministic sims with 31459 and all others
+  // randomly.
+  bool deterministic = false;
+  range::for_each( set.options() -> options, [ &deterministic ]( const option_tuple_t& opt ) {
+    if ( util::str_compare_ci( trim( opt.name ), "deterministic" ) )
+    {
+      deterministic = util::to_int( trim( opt.value ) ) != 0;
+    }
+  } );
+  std::string seed = deterministic ? "31459" : "random";
+
+  fmt::memory_buffer key;
+  fmt::format_to( key, "revision={}\nseed={}\n", git_info::revision(), seed );
+  range::for_each( parent -> profileset_metric, [ &key ]( scale_metric_e metric ) {
+    fmt::format_to( key, "metric={}\n", util::scale_metric_type_abbrev( metric ) );
+  } );
+  range::for_each( parent -> profileset_output_data, [ &key ]( const std::string& data ) {
+    fmt::format_to( key, "output_data={}\n", data );
+  } );
+
+  range::for_each( set.options() -> options, [ &key ]( const option_tuple_t& opt ) {
+    auto name = trim( opt.name );
+    if ( util::str_prefix_ci( name, "profileset_cache" ) ||
+         range::find_if( ignored_opts, [ &name ]( const std::string& ignored ) {
+           return util::str_compare_ci( name, ignored );
+         } ) != ignored_opts.end() )
+    {
+      return;
+    }
+
+    fmt::format_to( key, "{}:{}={}\n", opt.scope, name, trim( opt.value ) );
+  } );
+
+  return fmt::to_string( key );
+}
+
+// Serve the results of the profileset from the cache, if a matching entry exists
+bool result_cache_t::fetch( profile_set_t& set )
+{
+  if ( set.cache_key().empty() || m_refresh )
+  {
+    return false;
+  }
+
+  auto name = fmt::format( "{:016x}.json", fnv1a_64( set.cache_key() ) );
+
+#ifndef SC_NO_THREADING
+  std::lock_guard<std::mutex> lock( m_mutex );
+#endif
+
+  auto it = m_entries.find( name );
+  if ( it == m_entries.end() )
+  {
+    ++m_misses;
+    return false;
+  }
+
+  io::ifstream file;
+  file.open( path( name ) );
+  std::string content( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+
+  rapidjson::Document doc;
+  doc.Parse( content.c_str() );
+
+  // Entries with a different key (hash collision), or that went missing or are corrupt, are
+  // simulated again
+  if ( doc.HasParseError() || ! valid_cache_entry( doc ) || set.cache_key() != doc[ "key" ].GetString() )
+  {
+    ++m_misses;
+    return false;
+  }
+
+  for ( const auto& v : doc[ "results" ].GetArray() )
+  {
+    set.result( static_cast<scale_metric_e>( v[ "metric" ].GetInt() ) )
+      .mean( v[ "mean" ].GetDouble() )
+      .median( v[ "median" ].GetDouble() )
+      .min( v[ "min" ].GetDouble() )
+      .max( v[ "max" ].GetDouble() )
+      .first_quartile( v[ "first_quartile" ].GetDouble() )
+      .third_quartile( v[ "third_quartile" ].GetDouble() )
+      .stddev( v[ "stddev" ].GetDouble() )
+      .mean_stddev( v[ "mean_stddev" ].GetDouble() )
+      .iterations( v[ "iterations" ].GetUint64() );
+  }
+
+  if ( doc.HasMember( "output_data" ) )
+  {
+    const auto& v = doc[ "output_data" ];
+    auto& data = set.output_data();
+
+    data.race( static_cast<race_e>( v[ "race" ].GetInt() ) );
+    if ( v.HasMember( "talents" ) )
+    {
+      std::vector<talent_data_t*> talents;
+      for ( const auto& id : v[ "talents" ].GetArray() )
+      {
+        auto talent = talent_data_t::find( id.GetUint(), v[ "ptr" ].GetBool() );
+        if ( talent )
+        {
+          talents.push_back( talent );
+        }
+      }
+      data.talents( talents );
+    }
+    data.artifact( v[ "artifact" ].GetString() );
+    data.crucible( v[ "crucible" ].GetString() );
+
+    std::vector<profile_output_data_item_t> gear;
+    for ( const auto& item : v[ "gear" ].GetArray() )
+    {
+      gear.emplace_back( util::slot_type_string( util::parse_slot_type( item[ "slot" ].GetString() ) ),
+                         item[ "item_id" ].GetUint(), item[ "item_level" ].GetUint() );
+    }
+    data.gear( gear );
+
+    const auto& stats = v[ "stats" ];
+    data.crit_rating( stats[ "crit_rating" ].GetDouble() )
+      .crit_pct( stats[ "crit_pct" ].GetDouble() )
+      .haste_rating( stats[ "haste_rating" ].GetDouble() )
+      .haste_pct( stats[ "haste_pct" ].GetDouble() )
+      .mastery_rating( stats[ "mastery_rating" ].GetDouble() )
+      .mastery_pct( stats[ "mastery_pct" ].GetDouble() )
+      .versatility_rating( stats[ "versatility_rating" ].GetDouble() )
+      .versatility_pct( stats[ "versatility_pct" ].GetDouble() )
+      .agility( stats[ "agility" ].GetDouble() )
+      .strength( stats[ "strength" ].GetDouble() )
+      .intellect( stats[ "intellect" ].GetDouble() )
+      .stamina( stats[ "stamina" ].GetDouble() )
+      .avoidance_rating( stats[ "avoidance_rating" ].GetDouble() )
+      .avoidance_pct( stats[ "avoidance_pct" ].GetDouble() )
+      .leech_rating( stats[ "leech_rating" ].GetDouble() )
+      .leech_pct( stats[ "leech_pct" ].GetDouble() )
+      .speed_rating( stats[ "speed_rating" ].GetDouble() )
+      .speed_pct( stats[ "speed_pct" ].GetDouble() )
+      .corruption( stats[ "corruption" ].GetDouble() )
+      .corruption_resistance( stats[ "corruption_resistance" ].GetDouble() );
+  }
+
+  it -> second.last_use = ++m_clock;
+  ++m_hits;
+
+  return true;
 }
 
-std::thread& worker_t::thread()
+void result_cache_t::store( const sim_t* parent, const profile_set_t& set )
 {
-  return *m_thread;
+  if ( set.cache_key().empty() )
+  {
+    return;
+  }
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer( buffer );
+
+  writer.StartObject();
+  writer.Key( "key" );
+  writer.String( set.cache_key() );
+
+  writer.Key( "results" );
+  writer.StartArray();
+  range::for_each( parent -> profileset_metric, [ &writer, &set ]( scale_metric_e metric ) {
+    const auto& result = set.result( metric );
+    writer.StartObject();
+    writer.Key( "metric" );         writer.Int( metric );
+    writer.Key( "mean" );           writer.Double( result.mean() );
+    writer.Key( "median" );         writer.Double( result.median() );
+    writer.Key( "min" );            writer.Double( result.min() );
+    writer.Key( "max" );            writer.Double( result.max() );
+    writer.Key( "first_quartile" ); writer.Double( result.first_quartile() );
+    writer.Key( "third_quartile" ); writer.Double( result.third_quartile() );
+    writer.Key( "stddev" );         writer.Double( result.stddev() );
+    writer.Key( "mean_stddev" );    writer.Double( result.mean_stddev() );
+    writer.Key( "iterations" );     writer.Uint64( result.iterations() );
+    writer.EndObject();
+  } );
+  writer.EndArray();
+
+  if ( set.has_output_data() )
+  {
+    const auto& data = set.output_data();
+
+    writer.Key( "output_data" );
+    writer.StartObject();
+    writer.Key( "race" );
+    writer.Int( data.race() );
+    writer.Key( "ptr" );
+    writer.Bool( parent -> dbc.ptr );
+    if ( ! data.talents().empty() )
+    {
+      writer.Key( "talents" );
+      writer.StartArray();
+      range::for_each( data.talents(), [ &writer ]( const talent_data_t* talent ) { writer.Uint( talent -> id() ); } );
+      writer.EndArray();
+    }
+    writer.Key( "artifact" );
+    writer.String( data.artifact() );
+    writer.Key( "crucible" );
+    writer.String( data.crucible() );
+
+    writer.Key( "gear" );
+    writer.StartArray();
+    range::for_each( data.gear(), [ &writer ]( const profile_output_data_item_t& item ) {
+      writer.StartObject();
+      writer.Key( "slot" );       writer.String( item.slot_name() );
+      writer.Key( "item_id" );    writer.Uint( item.item_id() );
+      writer.Key( "item_level" ); writer.Uint( item.item_level() );
+      writer.EndObject();
+    } );
+    writer.EndArray();
+
+    writer.Key( "stats" );
+    writer.StartObject();
+    writer.Key( "crit_rating" );           writer.Double( data.crit_rating() );
+    writer.Key( "crit_pct" );              writer.Double( data.crit_pct() );
+    writer.Key( "haste_rating" );          writer.Double( data.haste_rating() );
+    writer.Key( "haste_pct" );             writer.Double( data.haste_pct() );
+    writer.Key( "mastery_rating" );        writer.Double( data.mastery_rating() );
+    writer.Key( "mastery_pct" );           writer.Double( data.mastery_pct() );
+    writer.Key( "versatility_rating" );    writer.Double( data.versatility_rating() );
+    writer.Key( "versatility_pct" );       writer.Double( data.versatility_pct() );
+    writer.Key( "agility" );               writer.Double( data.agility() );
+    writer.Key( "strength" );              writer.Double( data.strength() );
+    writer.Key( "intellect" );             writer.Double( data.intellect() );
+    writer.Key( "stamina" );               writer.Double( data.stamina() );
+    writer.Key( "avoidance_rating" );      writer.Double( data.avoidance_rating() );
+    writer.Key( "avoidance_pct" );         writer.Double( data.avoidance_pct() );
+    writer.Key( "leech_rating" );          writer.Double( data.leech_rating() );
+    writer.Key( "leech_pct" );             writer.Double( data.leech_pct() );
+    writer.Key( "speed_rating" );          writer.Double( data.speed_rating() );
+    writer.Key( "speed_pct" );             writer.Double( data.speed_pct() );
+    writer.Key( "corruption" );            writer.Double( data.corruption() );
+    writer.Key( "corruption_resistance" ); writer.Double( data.corruption_resistance() );
+    writer.EndObject();
+
+    writer.EndObject();
+  }
+
+  writer.EndObject();
+
+  auto name = fmt::format( "{:016x}.json", fnv1a_64( set.cache_key() ) );
+
+#ifndef SC_NO_THREADING
+  std::lock_guard<std::mutex> lock( m_mutex );
+#endif
+
+  // Write to a temporary file first, so readers never see a partially written entry
+  io::ofstream file;
+  file.open( path( name + ".tmp" ), std::ios::out | std::ios::trunc | std::ios::binary );
+  if ( ! file.is_open() )
+  {
+    return;
+  }
+  file << buffer.GetString();
+  file.close();
+
+  std::remove( path( name ).c_str() );
+  if ( std::rename( path( name + ".tmp" ).c_str(), path( name ).c_str() ) != 0 )
+  {
+    return;
+  }
+
+  auto& entry = m_entries[ name ];
+  m_size = m_size - entry.size + buffer.GetSize();
+  entry.size = buffer.GetSize();
+  entry.last_use = ++m_clock;
+
+  evict();
+
+  // Keep the index in sync with the entries on disk, so an interrupted run does not lose them
+  write_index();
 }
 
-const std::thread& worker_t::thread() const
+// Drop least recently used entries until the cache fits in its size limit. Caller must hold the
+// cache mutex.
+void result_cache_t::evict()
 {
-  return *m_thread;
+  while ( m_size > m_max_size && ! m_entries.empty() )
+  {
+    auto lru = std::min_element( m_entries.begin(), m_entries.end(),
+      []( const std::pair<const std::string, entry_t>& l, const std::pair<const std::string, entry_t>& r ) {
+        return l.second.last_use < r.second.last_use;
+    } );
+
+    std::remove( path( lru -> first ).c_str() );
+    m_size -= lru -> second.size;
+    m_entries.erase( lru );
+    ++m_evictions;
+  }
+}
+
+// Caller must hold the cache mutex
+void result_cache_t::write_index()
+{
+  io::ofstream index;
+  index.open( path( "index.tmp" ), std::ios::out | std::ios::trunc );
+  if ( ! index.is_open() )
+  {
+    return;
+  }
+
+  for ( const auto& entry : m_entries )
+  {
+    index << entry.first << ' ' << entry.second.size << ' ' << entry.second.last_use << '\n';
+  }
+  index.close();
+
+  std::remove( path( "index" ).c_str() );
+  std::rename( path( "index.tmp" ).c_str(), path( "index" ).c_str() );
+}
+
+// Records the recency of the cache hits of the run
+void result_cache_t::save_index()
+{
+  if ( ! enabled() )
+  {
+    return;
+  }
+
+#ifndef SC_NO_THREADING
+  std::lock_guard<std::mutex> lock( m_mutex );
+#endif
+
+  write_index();
+}
+
+worker_t::worker_t( profilesets_t* master, sim_t* p, profile_set_t* ps ) :
+  m_done( false ), m_parent( p ), m_master( master ), m_sim( nullptr ), m_profileset( ps )
+{
+  launch();
+}
+
+worker_t::~worker_t()
+{
+  delete m_sim;
 }
 
 sim_t* worker_t::sim() const
@@ -472,9 +1033,10 @@ void worker_t::execute()
 {
   try
   {
+    auto start = util::wall_time();
     m_sim = new sim_t( m_parent, 0, m_profileset -> options() );
 
-    simulate_profileset( m_parent, *m_profileset, m_sim );
+    simulate_profileset( m_parent, *m_profileset, m_sim, util::wall_time() - start );
   }
   catch (const std::exception& e )
   {
@@ -508,7 +1070,7 @@ void profilesets_t::cleanup_work()
   {
     if ( ( *it ) -> is_done() )
     {
-      ( *it ) -> thread().join();
+      ( *it ) -> join();
 
       auto sim = ( *it ) -> sim();
 
@@ -553,19 +1115,33 @@ void profilesets_t::finalize_work()
   }
 }
 
-void profilesets_t::generate_work( sim_t* parent, std::unique_ptr<profile_set_t>& ptr_set )
+void profilesets_t::generate_work( sim_t* parent, profile_set_t* set )
 {
+  if ( m_cache.enabled() )
+  {
+    set -> cache_key( m_cache.key( parent, *set ) );
+    if ( m_cache.fetch( *set ) )
+    {
+      if ( ! racing( parent ) )
+      {
+        set -> cleanup_options();
+      }
+      return;
+    }
+  }
+
   if ( m_mode == SEQUENTIAL )
   {
     auto original_opts = parent -> control;
 
-    parent -> control = ptr_set -> options();
+    parent -> control = set -> options();
 
+    auto start = util::wall_time();
     sim_t* profile_sim = new sim_t( parent );
 
     parent -> control = original_opts;
 
-    simulate_profileset( parent, *ptr_set.get(), profile_sim );
+    simulate_profileset( parent, *set, profile_sim, util::wall_time() - start );
 
     delete profile_sim;
   }
@@ -586,7 +1162,7 @@ void profilesets_t::generate_work( sim_t* parent, std::unique_ptr<profile_set_t>
       // Output profileset progressbar whenever we finish anything
       output_progressbar( parent );
 
-      m_current_work.push_back( std::make_unique<worker_t>( this, parent, ptr_set.get() ) );
+      m_current_work.push_back( std::make_unique<worker_t>( this, parent, set ) );
     }
 
     m_work_lock.unlock();
@@ -711,6 +1287,8 @@ void profilesets_t::initialize( sim_t* sim )
     return;
   }
 
+  m_cache.initialize( sim );
+
   // Figure out how many workers can we have by looking at how many threads we have, and how many
   // worker threads the user wants
   if ( sim -> profileset_work_threads > 0 )
@@ -828,10 +1406,17 @@ bool profilesets_t::iterate( sim_t* parent )
       }
     }
 
-    auto& set = m_profilesets[ m_work_index++ ];
+    auto set = m_profilesets[ m_work_index++ ].get();
 
     m_control_lock.unlock();
 
+    // In racing mode, the first round simulates all profilesets at low precision
+    if ( racing( parent ) )
+    {
+      set -> race_iterations( parent -> profileset_racing_iterations );
+      set -> add_race_round();
+    }
+
     generate_work( parent, set );
   }
 
@@ -839,6 +1424,10 @@ bool profilesets_t::iterate( sim_t* parent )
   // not need to finalize any work (all work has been done by the loop above)
   finalize_work();
 
+  race( parent );
+
+  m_cache.save_index();
+
   // Output profileset progressbar whenever we finish anything
   output_progressbar( parent );
 
@@ -852,6 +1441,110 @@ bool profilesets_t::iterate( sim_t* parent )
   return true;
 }
 
+// Racing only pays off if there are more profilesets than contenders, and the first round is
+// cheaper than the full simulation
+bool profilesets_t::racing( const sim_t* parent ) const
+{
+  return parent -> profileset_racing > 0 &&
+         parent -> profileset_map.size() > as<size_t>( parent -> profileset_racing ) &&
+         parent -> profileset_racing_iterations > 0 &&
+         parent -> profileset_racing_iterations < parent -> iterations;
+}
+
+// Successive rounds of racing. After each round, profilesets whose confidence interval on the
+// (first) profileset metric lies entirely below the lower bound of the profileset_racing'th best
+// profileset are eliminated. Remaining contenders are simulated again with profileset_racing_factor
+// times more iterations, until at most profileset_racing contenders remain, or the next round
+// would be as expensive as the full simulation. The final round simulates the contenders with their
+// own iteration options.
+void profilesets_t::race( sim_t* parent )
+{
+  if ( ! racing( parent ) )
+  {
+    return;
+  }
+
+  auto metric = parent -> profileset_metric.front();
+  auto top_n = as<size_t>( parent -> profileset_racing );
+
+  // Profilesets that failed to simulate do not take part
+  std::vector<profile_set_t*> contenders;
+  range::for_each( m_profilesets, [ &contenders, metric ]( const profileset_entry_t& set ) {
+    if ( set -> result( metric ).mean() != 0 )
+    {
+      contenders.push_back( set.get() );
+    }
+  } );
+
+  int iterations = parent -> profileset_racing_iterations;
+  bool final_round = false;
+  while ( ! final_round && ! parent -> canceled )
+  {
+    // Lower confidence bound of the top_n'th best contender
+    std::vector<double> lower_bounds;
+    range::transform( contenders, std::back_inserter( lower_bounds ), [ parent, metric ]( const profile_set_t* set ) {
+      const auto& result = set -> result( metric );
+      return result.mean() - result.mean_stddev() * parent -> confidence_estimator;
+    } );
+
+    if ( contenders.size() > top_n )
+    {
+      std::nth_element( lower_bounds.begin(), lower_bounds.begin() + ( top_n - 1 ), lower_bounds.end(),
+                        std::greater<double>() );
+      double threshold = lower_bounds[ top_n - 1 ];
+
+      auto it = std::remove_if( contenders.begin(), contenders.end(), [ parent, metric, threshold ]( profile_set_t* set ) {
+        const auto& result = set -> result( metric );
+        if ( result.mean() + result.mean_stddev() * parent -> confidence_estimator >= threshold )
+        {
+          return false;
+        }
+
+        set -> eliminate();
+        set -> cleanup_options();
+        set -> cleanup_race_samples();
+        return true;
+      } );
+      contenders.erase( it, contenders.end() );
+    }
+
+    // Racing results are already precise enough for a target_error based simulation
+    bool precise = parent -> target_error > 0 && range::find_if( contenders, [ parent, metric ]( const profile_set_t* set ) {
+      const auto& result = set -> result( metric );
+      return result.mean_stddev() * parent -> confidence_estimator * 100.0 / std::fabs( result.mean() ) >= parent -> target_error;
+    } ) == contenders.end();
+
+    if ( precise )
+    {
+      break;
+    }
+
+    iterations = as<int>( std::min( iterations * parent -> profileset_racing_factor,
+                                    static_cast<double>( parent -> iterations ) ) );
+    final_round = contenders.size() <= top_n || iterations >= parent -> iterations;
+
+    if ( parent -> report_progress )
+    {
+      fmt::print( "\nProfileset racing: {} of {} profilesets remain, next round {}\n",
+                  contenders.size(), m_profilesets.size(),
+                  final_round ? std::string( "is final" ) : fmt::format( "runs {} iterations", iterations ) );
+    }
+
+    range::for_each( contenders, [ this, parent, iterations, final_round ]( profile_set_t* set ) {
+      set -> race_iterations( final_round ? 0 : iterations );
+      set -> add_race_round();
+      generate_work( parent, set );
+    } );
+
+    finalize_work();
+  }
+
+  range::for_each( contenders, []( profile_set_t* set ) {
+    set -> cleanup_options();
+    set -> cleanup_race_samples();
+  } );
+}
+
 void profilesets_t::notify_worker()
 {
   m_work.notify_one();
@@ -960,6 +1653,14 @@ void profilesets_t::output_json( const sim_t& sim, js::JsonOutput& root ) const
     }
 
     obj[ "iterations" ] = as<uint64_t>( result.iterations() );
+    obj[ "init_time_seconds" ] = profileset -> init_time();
+    obj[ "simulate_time_seconds" ] = profileset -> simulate_time();
+
+    if ( profileset -> race_rounds() > 0 )
+    {
+      obj[ "race_rounds" ] = profileset -> race_rounds();
+      obj[ "eliminated" ] = profileset -> eliminated();
+    }
 
     if ( profileset -> results() > 1 )
     {
@@ -994,6 +1695,19 @@ void profilesets_t::output_json( const sim_t& sim, js::JsonOutput& root ) const
       fetch_output_data( output_data, ovr);
     }
   } );
+
+  if ( ! m_init_profile.entries.empty() )
+  {
+    auto init_arr = root[ "init_profile" ].make_array();
+    for ( const auto entry : m_init_profile.sorted() )
+    {
+      auto obj = init_arr.add();
+      obj[ "group" ] = entry -> group;
+      obj[ "phase" ] = entry -> phase;
+      obj[ "seconds" ] = entry -> time;
+      obj[ "count" ] = entry -> count;
+    }
+  }
 }
 
 void profilesets_t::output_text( const sim_t& sim, std::ostream& out ) const
@@ -1009,10 +1723,45 @@ void profilesets_t::output_text( const sim_t& sim, std::ostream& out ) const
   std::vector<const profile_set_t*> results;
   generate_sorted_profilesets( results );
 
-  range::for_each( results, [ &out ]( const profile_set_t* profileset ) {
-      fmt::print( out, "    {:-10.3f} : {:s}\n",
+  range::for_each( results, [ &out, &sim ]( const profile_set_t* profileset ) {
+      fmt::print( out, "    {:-10.3f} : {:s}",
       profileset -> result().median(), profileset -> name().c_str() );
+
+      // Racing mode results differ in precision, so show what each result is based on
+      if ( profileset -> race_rounds() > 0 )
+      {
+        const auto& result = profileset -> result();
+        fmt::print( out, " (error={:.3f} iterations={} {})",
+            result.mean_stddev() * sim.confidence_estimator, result.iterations(),
+            profileset -> eliminated()
+              ? fmt::format( "eliminated after {} round(s)", profileset -> race_rounds() )
+              : std::string( "contender" ) );
+      }
+
+      fmt::print( out, "\n" );
+  } );
+
+  double init_time = 0, simulate_time = 0;
+  range::for_each( m_profilesets, [ &init_time, &simulate_time ]( const profileset_entry_t& profileset ) {
+    init_time += profileset -> init_time();
+    simulate_time += profileset -> simulate_time();
   } );
+
+  fmt::print( out, "\n  Profileset Time: init={:.3f}s simulate={:.3f}s ({:.1f}% init)\n",
+    init_time, simulate_time,
+    init_time + simulate_time > 0 ? 100.0 * init_time / ( init_time + simulate_time ) : 0.0 );
+
+  if ( m_cache.enabled() )
+  {
+    fmt::print( out, "  Profileset Cache: hits={} misses={} evictions={}\n",
+      m_cache.hits(), m_cache.misses(), m_cache.evictions() );
+  }
+
+  if ( ! m_init_profile.entries.empty() )
+  {
+    fmt::print( out, "\n" );
+    report::print_init_profile( out, m_init_profile, "  Profileset Init Profile" );
+  }
 }
 
 void profilesets_t::output_html( const sim_t& sim, std::ostream& out ) const
@@ -1028,6 +1777,36 @@ void profilesets_t::output_html( const sim_t& sim, std::ostream& out ) const
 
   generate_chart( sim, out );
 
+  // Racing mode results differ in precision, so show what each result is based on
+  if ( range::find_if( m_profilesets, []( const profileset_entry_t& profileset ) {
+         return profileset -> race_rounds() > 0;
+       } ) != m_profilesets.end() )
+  {
+    std::vector<const profile_set_t*> results;
+    generate_sorted_profilesets( results );
+
+    out << "<table class=\"sc even\">\n"
+        << "<tr>\n"
+        << "<th class=\"left\">Profileset</th>\n"
+        << "<th>Median</th>\n"
+        << "<th>Error</th>\n"
+        << "<th>Iterations</th>\n"
+        << "<th class=\"left\">Racing</th>\n"
+        << "</tr>\n";
+
+    range::for_each( results, [ &out, &sim ]( const profile_set_t* profileset ) {
+      const auto& result = profileset -> result();
+      fmt::print( out, "<tr><td class=\"left\">{}</td><td>{:.3f}</td><td>{:.3f}</td><td>{}</td><td class=\"left\">{}</td></tr>\n",
+          util::encode_html( profileset -> name() ), result.median(),
+          result.mean_stddev() * sim.confidence_estimator, result.iterations(),
+          profileset -> eliminated()
+            ? fmt::format( "eliminated after {} round(s)", profileset -> race_rounds() )
+            : std::string( "contender" ) );
+    } );
+
+    out << "</table>\n";
+  }
+
   out << "</div>";
   out << "</div>";
 }
@@ -1209,6 +1988,12 @@ void create_options( sim_t* sim )
 
   sim -> add_option( opt_int( "profileset_work_threads", sim -> profileset_work_threads ) );
   sim -> add_option( opt_int( "profileset_init_threads", sim -> profileset_init_threads ) );
+  sim -> add_option( opt_int( "profileset_racing", sim -> profileset_racing ) );
+  sim -> add_option( opt_int( "profileset_racing_iterations", sim -> profileset_racing_iterations ) );
+  sim -> add_option( opt_float( "profileset_racing_factor", sim -> profileset_racing_factor, 2.0, 100.0 ) );
+  sim -> add_option( opt_string( "profileset_cache_dir", sim -> profileset_cache_dir ) );
+  sim -> add_option( opt_int( "profileset_cache_size", sim -> profileset_cache_size ) );
+  sim -> add_option( opt_bool( "profileset_cache_refresh", sim -> profileset_cache_refresh ) );
 }
 
 statistical_data_t collect( const extended_sample_data_t& c )
@@ -1217,28 +2002,40 @@ statistical_data_t collect( const extended_sample_data_t& c )
            c.percentile( 0.75 ), c.max(), c.std_dev, c.mean_std_dev };
 }
 
-statistical_data_t metric_data( const player_t* player, scale_metric_e metric )
+std::vector<const extended_sample_data_t*> metric_samples( const player_t* player, scale_metric_e metric )
 {
   const auto& d = player -> collected_data;
 
   switch ( metric )
   {
-    case SCALE_METRIC_DPS:       return collect( d.dps );
-    case SCALE_METRIC_DPSE:      return collect( d.dpse );
-    case SCALE_METRIC_HPS:       return collect( d.hps );
-    case SCALE_METRIC_HPSE:      return collect( d.hpse );
-    case SCALE_METRIC_APS:       return collect( d.aps );
-    case SCALE_METRIC_DPSP:      return collect( d.prioritydps );
-    case SCALE_METRIC_DTPS:      return collect( d.dtps );
-    case SCALE_METRIC_DMG_TAKEN: return collect( d.dmg_taken );
-    case SCALE_METRIC_HTPS:      return collect( d.htps );
-    case SCALE_METRIC_TMI:       return collect( d.theck_meloree_index );
-    case SCALE_METRIC_ETMI:      return collect( d.effective_theck_meloree_index );
-    case SCALE_METRIC_DEATHS:    return collect( d.deaths );
-    case SCALE_METRIC_HAPS:
-    {
-      auto hps = collect( d.hps );
-      auto aps = collect( d.aps );
+    case SCALE_METRIC_DPS:       return { &d.dps };
+    case SCALE_METRIC_DPSE:      return { &d.dpse };
+    case SCALE_METRIC_HPS:       return { &d.hps };
+    case SCALE_METRIC_HPSE:      return { &d.hpse };
+    case SCALE_METRIC_APS:       return { &d.aps };
+    case SCALE_METRIC_DPSP:      return { &d.prioritydps };
+    case SCALE_METRIC_DTPS:      return { &d.dtps };
+    case SCALE_METRIC_DMG_TAKEN: return { &d.dmg_taken };
+    case SCALE_METRIC_HTPS:      return { &d.htps };
+    case SCALE_METRIC_TMI:       return { &d.theck_meloree_index };
+    case SCALE_METRIC_ETMI:      return { &d.effective_theck_meloree_index };
+    case SCALE_METRIC_DEATHS:    return { &d.deaths };
+    case SCALE_METRIC_HAPS:      return { &d.hps, &d.aps };
+    default:                     return {};
+  }
+}
+
+// Metrics computed from several collected data (HAPS) are the sum of them
+statistical_data_t metric_data( const std::vector<const extended_sample_data_t*>& samples )
+{
+  switch ( samples.size() )
+  {
+    case 1:
+      return collect( *samples[ 0 ] );
+    case 2:
+    {
+      auto hps = collect( *samples[ 0 ] );
+      auto aps = collect( *samples[ 1 ] );
       return {
         hps.min + aps.min,
         hps.first_quartile + aps.first_quartile,
@@ -1246,14 +2043,20 @@ statistical_data_t metric_data( const player_t* player, scale_metric_e metric )
         hps.mean + aps.mean,
         hps.third_quartile + aps.first_quartile,
         hps.max + aps.max,
-        sqrt( d.aps.variance + d.hps.variance ),
-        sqrt( d.aps.mean_variance + d.hps.mean_variance )
+        sqrt( samples[ 1 ] -> variance + samples[ 0 ] -> variance ),
+        sqrt( samples[ 1 ] -> mean_variance + samples[ 0 ] -> mean_variance )
       };
     }
-    default:                     return { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    default:
+      return { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
   }
 }
 
+statistical_data_t metric_data( const player_t* player, scale_metric_e metric )
+{
+  return metric_data( metric_samples( player, metric ) );
+}
+
 void save_output_data( profile_set_t& profileset, const player_t* parent_player, const player_t* player, std::string option )
 {
   // TODO: Make an enum to proper use a switch instead of if/else
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 #ifndef SC_NO_THREADING
 #include <thread>
@@ -14,15 +15,17 @@
 #include <condition_variable>
 #endif
 
+#include "sc_init_profile.hpp"
 #include "sc_option.hpp"
 #include "util/generic.hpp"
 #include "util/io.hpp"
+#include "util/concurrency.hpp"
+#include "util/sample_data.hpp"
 #include "sc_enums.hpp"
 
 struct sim_t;
 struct sim_control_t;
 struct player_t;
-class extended_sample_data_t;
 struct talent_data_t;
 
 namespace js {
@@ -230,7 +233,11 @@ class profile_output_data_t
             m_corruption_resistance;
 
 public:
-  profile_output_data_t() : m_race ( RACE_NONE )
+  profile_output_data_t() : m_race ( RACE_NONE ),
+    m_crit_rating( 0 ), m_crit_pct( 0 ), m_haste_rating( 0 ), m_haste_pct( 0 ), m_mastery_rating( 0 ),
+    m_mastery_pct( 0 ), m_versatility_rating( 0 ), m_versatility_pct( 0 ), m_agility( 0 ), m_strength( 0 ),
+    m_intellect( 0 ), m_stamina( 0 ), m_avoidance_rating( 0 ), m_avoidance_pct( 0 ), m_leech_rating( 0 ),
+    m_leech_pct( 0 ), m_speed_rating( 0 ), m_speed_pct( 0 ), m_corruption( 0 ), m_corruption_resistance( 0 )
   { }
 
   race_e race() const
@@ -391,6 +398,14 @@ class profile_set_t
   bool                                   m_has_output;
   std::vector<profile_result_t>          m_results;
   std::unique_ptr<profile_output_data_t> m_output_data;
+  double                                 m_init_time;
+  double                                 m_simulate_time;
+  int                                    m_race_iterations;
+  unsigned                               m_race_rounds;
+  int                                    m_race_iterations_done;
+  bool                                   m_eliminated;
+  std::vector<std::pair<scale_metric_e, std::vector<extended_sample_data_t>>> m_race_samples;
+  std::string                            m_cache_key;
 
 public:
   profile_set_t( const std::string& name, sim_control_t* opts, bool has_output );
@@ -414,6 +429,69 @@ public:
   size_t results() const
   { return m_results.size(); }
 
+  // Wall time spent outside iterations (sim construction, initialization, merge and analysis)
+  double init_time() const
+  { return m_init_time; }
+
+  // Wall time spent iterating
+  double simulate_time() const
+  { return m_simulate_time; }
+
+  // Timings accumulate over all the runs of the profileset (racing mode runs a set several times)
+  void add_timing( double init, double simulate )
+  { m_init_time += init; m_simulate_time += simulate; }
+
+  // Iterations the racing rounds up to and including the next one add up to, 0 for the iteration
+  // options of the set
+  int race_iterations() const
+  { return m_race_iterations; }
+
+  void race_iterations( int iterations )
+  { m_race_iterations = iterations; }
+
+  // Number of racing rounds the profileset was simulated in
+  unsigned race_rounds() const
+  { return m_race_rounds; }
+
+  void add_race_round()
+  { ++m_race_rounds; }
+
+  // Iterations simulated by the racing rounds so far. Each round only simulates the iterations it
+  // adds, the results are computed from the samples of all rounds.
+  int race_iterations_done() const
+  { return m_race_iterations_done; }
+
+  void add_race_iterations( int iterations )
+  { m_race_iterations_done += iterations; }
+
+  // Merge the samples of a metric from a racing round into those of the earlier rounds, and return
+  // the (analyzed) samples of all rounds
+  std::vector<const extended_sample_data_t*> add_race_samples( scale_metric_e metric,
+                                                               const std::vector<const extended_sample_data_t*>& samples );
+
+  void cleanup_race_samples()
+  { m_race_samples.clear(); }
+
+  // Dropped by racing mode before the final round, results are at racing precision
+  bool eliminated() const
+  { return m_eliminated; }
+
+  void eliminate()
+  { m_eliminated = true; }
+
+  // Result cache key of the current run of the profileset, empty if caching is disabled
+  const std::string& cache_key() const
+  { return m_cache_key; }
+
+  void cache_key( const std::string& key )
+  { m_cache_key = key; }
+
+  bool has_output_data() const
+  { return m_output_data != nullptr; }
+
+  const profile_output_data_t& output_data() const
+  { return *m_output_data; }
+
   profile_output_data_t& output_data()
   {
     if ( ! m_output_data )
@@ -425,8 +503,64 @@ public:
   }
 };
 
+// On-disk cache of profileset results. Entries are stored as one JSON file per profileset run in
+// the cache directory, named after a hash of the normalized simulation options, the engine
+// revision and the seed. Recency of use is kept in an index file, and the
+// least recently used entries are evicted when the cache grows over its size limit. The cache is
+// disabled for engine builds without revision information.
+class result_cache_t
+{
+  struct entry_t
+  {
+    uint64_t size;
+    uint64_t last_use;
+  };
+
+  std::string                            m_dir;
+  uint64_t                               m_max_size;
+  uint64_t                               m_size;
+  uint64_t                               m_clock;
+  bool                                   m_refresh;
+  std::unordered_map<std::string, entry_t> m_entries;
+  size_t                                 m_hits;
+  size_t                                 m_misses;
+  size_t                                 m_evictions;
 #ifndef SC_NO_THREADING
-class worker_t
+  std::mutex                             m_mutex;
+#endif
+
+  std::string path( const std::string& name ) const;
+  void evict();
+  void write_index();
+
+public:
+  result_cache_t() : m_max_size( 0 ), m_size( 0 ), m_clock( 0 ), m_refresh( false ),
+    m_hits( 0 ), m_misses( 0 ), m_evictions( 0 )
+  { }
+
+  bool enabled() const
+  { return ! m_dir.empty(); }
+
+  size_t hits() const
+  { return m_hits; }
+
+  size_t misses() const
+  { return m_misses; }
+
+  size_t evictions() const
+  { return m_evictions; }
+
+  void initialize( sim_t* sim );
+  std::string key( const sim_t* parent, const profile_set_t& set ) const;
+  bool fetch( profile_set_t& set );
+  void store( const sim_t* parent, const profile_set_t& set );
+  void save_index();
+};
+
+#ifndef SC_NO_THREADING
+// Profileset workers run on the pooled sc_thread_t threads, so consecutive profilesets reuse the
+// same system threads instead of creating a new one per profileset.
+class worker_t : private sc_thread_t
 {
   bool           m_done;
   sim_t*         m_parent;
@@ -434,14 +568,15 @@ class worker_t
 
   sim_t*         m_sim;
   profile_set_t* m_profileset;
-  std::thread*   m_thread;
+
+  void run() override
+  { execute(); }
 
 public:
   worker_t( profilesets_t*, sim_t*, profile_set_t* );
   ~worker_t();
 
-  const std::thread& thread() const;
-  std::thread& thread();
+  using sc_thread_t::join;
   void execute();
 
   bool is_done() const
@@ -485,6 +620,14 @@ class profilesets_t
   std::vector<std::thread>               m_thread;
 #endif
 
+  result_cache_t                         m_cache;
+
+  // Init phase times of the profileset sims by class module, collected with init_profile=1
+  init_profile_t                         m_init_profile;
+#ifndef SC_NO_THREADING
+  std::mutex                             m_init_profile_mutex;
+#endif
+
   // Shared iterator for threaded init workers
   opts::map_list_t::const_iterator       m_init_index;
 
@@ -516,7 +659,8 @@ class profilesets_t
   void set_state( state new_state );
 
   size_t n_workers() const;
-  void generate_work( sim_t*, std::unique_ptr<profile_set_t>& );
+  void generate_work( sim_t*, profile_set_t* );
+  void race( sim_t* );
   void cleanup_work();
   void finalize_work();
 
@@ -544,15 +688,29 @@ public:
       }
     } );
 
-    range::for_each( m_current_work, []( std::unique_ptr<worker_t>& worker ) { worker -> thread().join(); } );
+    range::for_each( m_current_work, []( std::unique_ptr<worker_t>& worker ) { worker -> join(); } );
 #endif
   }
 
   size_t n_profilesets() const
   { return m_profilesets.size(); }
 
+  result_cache_t& cache()
+  { return m_cache; }
+
   size_t done_profilesets() const;
 
+  /// Profilesets are raced, and may be simulated more than once
+  bool racing( const sim_t* ) const;
+
+  void add_init_profile( const init_profile_t& profile )
+  {
+#ifndef SC_NO_THREADING
+    std::lock_guard<std::mutex> lock( m_init_profile_mutex );
+#endif
+    m_init_profile.merge_groups( profile );
+  }
+
   // Worker sim finished
   void notify_worker();
 
@@ -586,6 +744,9 @@ public:
 void create_options( sim_t* sim );
 
 statistical_data_t collect( const extended_sample_data_t& c );
+// Collected data of the actor the metric is computed from
+std::vector<const extended_sample_data_t*> metric_samples( const player_t* player, scale_metric_e metric );
+statistical_data_t metric_data( const std::vector<const extended_sample_data_t*>& samples );
 statistical_data_t metric_data( const player_t* player, scale_metric_e metric );
 void save_output_data( profile_set_t& profileset, const player_t* parent_player, const player_t* player, std::string option );
 void fetch_output_data( const profile_output_data_t output_data, js::JsonOutput& ovr );
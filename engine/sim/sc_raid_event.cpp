@@ -289,8 +289,7 @@ struct adds_event_t : public raid_event_t
         }
 
         adds[ i ]->summon( duration_time() );
-        adds[ i ]->x_position = x_offset + spawn_x_coord;
-        adds[ i ]->y_position = y_offset + spawn_y_coord;
+        adds[ i ]->set_position( x_offset + spawn_x_coord, y_offset + spawn_y_coord );
 
         if ( sim->log )
         {
@@ -370,8 +369,7 @@ struct move_enemy_t : public raid_event_t
 
     if ( enemy )
     {
-      enemy->x_position = enemy->default_x_position;
-      enemy->y_position = enemy->default_y_position;
+      enemy->set_position( enemy->default_x_position, enemy->default_y_position );
     }
   }
 
@@ -381,8 +379,7 @@ struct move_enemy_t : public raid_event_t
     {
       original_x        = enemy->x_position;
       original_y        = enemy->y_position;
-      enemy->x_position = x_coord;
-      enemy->y_position = y_coord;
+      enemy->set_position( x_coord, y_coord );
       regenerate_cache();
     }
   }
@@ -391,8 +388,7 @@ struct move_enemy_t : public raid_event_t
   {
     if ( enemy )
     {
-      enemy->x_position = enemy->default_x_position;
-      enemy->y_position = enemy->default_y_position;
+      enemy->set_position( enemy->default_x_position, enemy->default_y_position );
       regenerate_cache();
     }
   }
@@ -809,6 +809,25 @@ bool parse_maximize_reporting( sim_t*             sim,
   return true;
 }
 
+// parse_sample_data_sketch =================================================
+
+bool parse_sample_data_sketch( sim_t*             sim,
+                               const std::string& /* name */,
+                               const std::string& value )
+{
+  double compression = std::stod( value );
+
+  // A sketch keeps a buffer of 5 * compression samples, so it needs a compression of at least 1
+  if ( compression != 0 && ( compression < 1 || compression > 10000 ) )
+  {
+    throw std::invalid_argument( "Acceptable values are 0 (disabled) or between 1 and 10000." );
+  }
+
+  sim -> sample_data_sketch = compression;
+
+  return true;
+}
+
 /**
  * Parse threads option, and if equal or lower than 0, adjust
  * the number of threads to the number of cpu cores minus the absolute value given as a thread option.
@@ -927,7 +946,7 @@ struct sim_safeguard_end_event_t : public sim_end_event_t
 struct resource_timeline_collect_event_t : public event_t
 {
   resource_timeline_collect_event_t( sim_t& s ) :
-    event_t( s, timespan_t::from_seconds( 1 ) )
+    event_t( s, sc_timeline_t::bin_duration( s.timeline_bin_size ) )
   {
   }
   const char* name() const override
@@ -1343,7 +1362,8 @@ sim_t::sim_t() :
   travel_variance( 0 ), default_skill( 1.0 ), reaction_time( timespan_t::from_seconds( 0.5 ) ),
   regen_periodicity( timespan_t::from_seconds( 0.25 ) ),
   ignite_sampling_delta( timespan_t::from_seconds( 0.2 ) ),
-  fixed_time( true ), optimize_expressions( false ),
+  fixed_time( true ), optimize_expressions( false ), compile_expressions( false ),
+  dirty_reset( false ), dirty_reset_verify( false ),
   current_slot( -1 ),
   optimal_raid( 0 ), log( 0 ),
   debug_each( 0 ),
@@ -1385,6 +1405,8 @@ sim_t::sim_t() :
   elapsed_cpu( 0.0 ),
   elapsed_time( 0.0 ),
   work_done( 0 ),
+  busy_time( 0 ), run_time( 0 ),
+  iteration_index( 0 ), base_seed( 0 ),
   iteration_dmg( 0 ), priority_iteration_dmg( 0 ), iteration_heal( 0 ), iteration_absorb( 0 ),
   raid_dps(), total_dmg(), raid_hps(), total_heal(), total_absorb(), raid_aps(),
   simulation_length( "Simulation Length", false ),
@@ -1394,9 +1416,9 @@ sim_t::sim_t() :
   bloodlust_percent( 25 ), bloodlust_time( timespan_t::from_seconds( 0.5 ) ),
   // Report
   report_precision(2), report_pets_separately( 0 ), report_targets( 1 ), report_details( 1 ), report_raw_abilities( 1 ),
-  report_rng( 0 ), hosted_html( 0 ),
-  save_raid_summary( 0 ), save_gear_comments( 0 ), statistics_level( 1 ), separate_stats_by_actions( 0 ), report_raid_summary( 0 ),
-  buff_uptime_timeline( 0 ), buff_stack_uptime_timeline( 0 ),
+  report_rng( 0 ), report_stat_cache( 0 ), report_callbacks( 0 ), hosted_html( 0 ),
+  save_raid_summary( 0 ), save_gear_comments( 0 ), statistics_level( 1 ), sample_data_sketch( 0 ), separate_stats_by_actions( 0 ), report_raid_summary( 0 ),
+  buff_uptime_timeline( 0 ), buff_stack_uptime_timeline( 0 ), timeline_bin_size( 1.0 ),
   json_full_states( 0 ),
   decorated_tooltips( -1 ),
   allow_potions( true ),
@@ -1427,7 +1449,13 @@ sim_t::sim_t() :
   profileset_output_data(),
   profileset_enabled( false ),
   profileset_work_threads( 0 ),
-  profileset_init_threads( 1 )
+  profileset_init_threads( 1 ),
+  profileset_racing( 0 ),
+  profileset_racing_iterations( 100 ),
+  profileset_racing_factor( 4.0 ),
+  profileset_cache_dir(),
+  profileset_cache_size( 256 ),
+  profileset_cache_refresh( false )
 {
   item_db_sources.assign( std::begin( default_item_db_sources ),
                           std::end( default_item_db_sources ) );
@@ -1525,8 +1553,10 @@ double sim_t::iteration_time_adjust() const
   }
   else
   {
-    auto progress = work_queue -> progress();
-    return 1.0 + vary_combat_length * ( ( current_iteration % 2 ) ? 1 : -1 ) * progress.pct();
+    // Based on the global iteration index, so the length of an iteration does not depend on the
+    // thread running it.
+    return 1.0 + vary_combat_length * ( ( iteration_index % 2 ) ? 1 : -1 ) *
+                 work_queue -> iteration_pct( iteration_index );
   }
 }
 
@@ -1603,11 +1633,14 @@ void sim_t::cancel()
 
 void sim_t::interrupt()
 {
-  work_queue -> flush();
+  // Single actor batch sims only stop the batch of the actor that reached the target error
+  int idx = single_actor_batch ? as<int>( current_index ) : -1;
+
+  work_queue -> flush( idx );
 
   for (auto & child : children)
   {
-    child -> interrupt();
+    child -> work_queue -> flush( idx );
   }
 }
 
@@ -1651,15 +1684,20 @@ void sim_t::reset()
   if ( debug )
     out_debug << "Resetting Simulator";
 
+  // Deterministic sims seed each iteration from its global index, so results do not depend on which
+  // thread ran the iteration.
   if( deterministic )
-    seed = rng().reseed();
+  {
+    seed = rng::stream_seed( base_seed, iteration_index );
+    rng().seed( seed );
+    rng().reset();
+  }
 
   event_mgr.reset();
 
   expected_iteration_time = max_time * iteration_time_adjust();
 
-  for ( auto& buff : buff_list )
-    buff -> reset();
+  buff_t::reset_buffs( *this, buff_list, dirty_buffs );
 
   for ( auto& target : target_list )
   {
@@ -1955,6 +1993,11 @@ void sim_t::datacollection_end()
       iteration_data.push_back( entry );
     }
   }
+
+  if ( iteration_data_output )
+  {
+    iteration_data_output -> collect( *this );
+  }
 }
 
 // sim_t::analyze_error =====================================================
@@ -1965,19 +2008,17 @@ void sim_t::analyze_error()
   if ( target_error <= 0 ) return;
   if ( current_iteration < 1 ) return;
 
-  work_queue -> lock();
-
-  int n_iterations = work_queue -> progress().current_iterations;
+  int idx = single_actor_batch ? as<int>( current_index ) : -1;
+  int n_iterations = work_queue -> progress( idx ).current_iterations;
   if ( strict_work_queue )
   {
-    range::for_each( children, [ &n_iterations ]( sim_t* c ) {
-      n_iterations += c -> work_queue -> progress().current_iterations;
+    range::for_each( children, [ &n_iterations, idx ]( sim_t* c ) {
+      n_iterations += c -> work_queue -> progress( idx ).current_iterations;
     } );
   }
 
   if ( n_iterations < analyze_error_interval * ( analyze_number + 1 ) )
   {
-    work_queue -> unlock();
     return;
   }
 
@@ -2046,21 +2087,19 @@ void sim_t::analyze_error()
           ( target_error *  target_error ) ) );
       if ( ! strict_work_queue )
       {
-        work_queue -> project( projected_iterations );
+        work_queue -> project( projected_iterations, idx );
       }
       else
       {
         // Divide work evenly between threads
         projected_iterations /= threads;
-        work_queue -> project( projected_iterations );
-        range::for_each( children, [ projected_iterations ]( sim_t* c ) {
-          c -> work_queue -> project( projected_iterations );
+        work_queue -> project( projected_iterations, idx );
+        range::for_each( children, [ projected_iterations, idx ]( sim_t* c ) {
+          c -> work_queue -> project( projected_iterations, idx );
         } );
       }
     }
   }
-
-  work_queue -> unlock();
 }
 
 /**
@@ -2344,6 +2383,8 @@ void sim_t::init_actor( player_t* p )
 {
   try
   {
+    init_profile_t::timer_t timer( init_profile, p, "init_module" );
+
     // initialize class/enemy modules
     for ( player_e i = PLAYER_NONE; i < PLAYER_MAX; ++i )
     {
@@ -2357,6 +2398,7 @@ void sim_t::init_actor( player_t* p )
       p -> action_list_str.clear();
     }
 
+    timer.next( "init" );
     p -> init();
     p -> initialized = true;
 
@@ -2366,56 +2408,81 @@ void sim_t::init_actor( player_t* p )
     // For now, we're only enforcing this condition for the particular init_* methods that can
     // lead to a sim -> cancel() result ( player_t::init_items() and player_t::init_actions() ).
 
+    timer.next( "init_target" );
     p -> init_target();
+    timer.next( "init_character_properties" );
     p -> init_character_properties();
 
     // Initialize each actor's items, construct gear information & stats
+    timer.next( "init_items" );
     p -> init_items();
 
     // Must be done after init_items (processes item options, so we know selected azerite powers in
     // each item), and before init_spells (class modules "find_azerite_spell" in these).
+    timer.next( "init_azerite" );
     p -> init_azerite();
+    timer.next( "init_spells" );
     p -> init_spells();
+    timer.next( "init_base_stats" );
     p -> init_base_stats();
+    timer.next( "create_buffs" );
     p -> create_buffs();
 
     // First-phase creation of special effects from various sources. Needed to be able to create
     // actions (APLs, really) based on the presence of special effects on items.
+    timer.next( "create_special_effects" );
     p -> create_special_effects();
 
     // First, create all the action objects and set up action lists properly
+    timer.next( "create_actions" );
     p -> create_actions();
 
     // Create persistent actors from dynamic spawners
+    timer.next( "create_persistent_actors" );
     spawner::create_persistent_actors( *p );
 
     // Create all actor pets before special effects get initialized. This ensures that we can use
     // stuff like the presence of an action (created with create_actions()) to determine if a pet
     // needs to be created or not. Similarly, talent, artifact, spec, and item based qualifiers would
     // work.
+    timer.next( "create_pets" );
     p -> create_pets();
 
     // Second-phase initialize all special effects and register them to actors
+    timer.next( "init_special_effects" );
     p -> init_special_effects();
 
     // Finally, initialize all action objects
+    timer.next( "init_actions" );
     p -> init_actions();
 
     // Once all transient properties are initialized (e.g., base stats, spells, special effects,
     // items), initialize the initial stats of the actor.
+    timer.next( "init_initial_stats" );
     p -> init_initial_stats();
     // And once initial stats are initialized, derive the passive defensive properties of the actor.
+    timer.next( "init_defense" );
     p -> init_defense();
 
+    timer.next( "init_scaling" );
     p -> init_scaling();
+    timer.next( "init_gains" );
     p -> init_gains();
+    timer.next( "init_procs" );
     p -> init_procs();
+    timer.next( "init_uptimes" );
     p -> init_uptimes();
+    timer.next( "init_benefits" );
     p -> init_benefits();
+    timer.next( "init_rng" );
     p -> init_rng();
+    timer.next( "init_stats" );
     p -> init_stats();
+    timer.next( "init_distance_targeting" );
     p -> init_distance_targeting();
+    timer.next( "init_absorb_priority" );
     p -> init_absorb_priority();
+    timer.next( "init_assessors" );
     p -> init_assessors();
   }
   catch (const std::exception&)
@@ -2461,6 +2528,8 @@ void sim_t::init()
   if ( initialized )
     return;
 
+  init_profile_t::timer_t timer( init_profile, nullptr, "setup" );
+
   event_mgr.init();
 
   unique_gear::register_target_data_initializers( this );
@@ -2480,6 +2549,8 @@ void sim_t::init()
   }
   _rng = rng::create( rng::parse_type( rng_str ) );
   _rng -> seed( seed + thread_index );
+  // Strict work queues number iterations per thread, so their streams need a per-thread base
+  base_seed = seed + ( strict_work_queue ? thread_index : 0 );
 
   if (   queue_lag_stddev == timespan_t::zero() )   queue_lag_stddev =   queue_lag * 0.25;
   if (     gcd_lag_stddev == timespan_t::zero() )     gcd_lag_stddev =     gcd_lag * 0.25;
@@ -2532,6 +2603,7 @@ void sim_t::init()
                            ->add_invalidate( CACHE_STAMINA );
 
   // Find Already defined target, otherwise create a new one.
+  timer.next( "create_enemies" );
   if ( debug )
     out_debug << "Creating Enemies.";
 
@@ -2596,11 +2668,17 @@ void sim_t::init()
 
   // Fight style initialization must be performed before raid event initialization, since fight
   // styles may define raid events.
+  timer.next( "init_fight_style" );
   init_fight_style();
 
+  timer.next( "init_raid_events" );
   raid_event_t::init( this );
 
-  // Initialize actors
+  // Timelines created during actor initialization claim bins for the longest expected fight
+  timeline_arena.set_length( expected_max_time() );
+
+  // Initialize actors, timed per actor and phase
+  timer.stop();
   init_actors();
 
   if ( report_precision < 0 ) report_precision = 2;
@@ -2626,6 +2704,7 @@ void sim_t::init()
     {
       try
       {
+        init_profile_t::timer_t actor_timer( init_profile, actor, "init_finished" );
         actor -> init_finished();
       }
       catch (const std::exception&)
@@ -2654,7 +2733,9 @@ void sim_t::init()
   // exit in any case
   if ( active_player && active_player->report_information.save_str.empty() )
   {
+    timer.next( "init_profilesets" );
     profilesets.initialize( this );
+    timer.stop();
   }
 
   initialized = true;
@@ -2759,15 +2840,25 @@ bool sim_t::iterate()
 
   progress_bar.init();
 
+  if ( iteration_data_file )
+  {
+    iteration_data_output = std::make_unique<report::iteration_data_output_t>( iteration_data_file, *this );
+  }
+
   activate_actors();
 
+  auto run_start = std::chrono::high_resolution_clock::now();
+  iteration_index = 0;
+
   bool more_work = true;
   do
   {
     ++current_iteration;
     ++work_done;
 
+    auto iteration_start = std::chrono::high_resolution_clock::now();
     combat();
+    busy_time += util::duration_fp_seconds( iteration_start );
 
     if ( progress_bar.update( false, as<int>(current_index) ) )
     {
@@ -2778,8 +2869,9 @@ bool sim_t::iterate()
     auto old_active = current_index;
     if ( ! canceled )
     {
-      current_index = work_queue -> pop();
-      more_work = work_queue -> more_work();
+      size_t next_index = current_index;
+      more_work = work_queue -> pop( thread_index, iteration_index, next_index );
+      current_index = next_index;
 
       if ( more_work && current_index != old_active )
       {
@@ -2797,6 +2889,16 @@ bool sim_t::iterate()
     }
   } while ( more_work && ! canceled );
 
+  run_time = util::duration_fp_seconds( run_start );
+
+  cpu_profile.finalize();
+
+  if ( iteration_data_output )
+  {
+    iteration_data_output -> flush();
+    iteration_data_output.reset();
+  }
+
   if ( ! canceled && progress_bar.update( true, as<int>(current_index) ) )
   {
     progress_bar.output( true );
@@ -2845,22 +2947,51 @@ void sim_t::do_pause()
 }
 
 /// merge sims
-void sim_t::merge( sim_t& other_sim )
+namespace
 {
-  auto_lock_t auto_lock( merge_mutex );
-  auto start = std::chrono::high_resolution_clock::now();
+/* Merges one sim into another on a pool thread, as one step of the parallel merge reduction.
+ */
+class merge_task_t : private sc_thread_t
+{
+  sim_t& target;
+  sim_t& source;
 
-  if ( scaling -> scale_stat == STAT_NONE &&
-       scaling -> calculate_scale_factors == 0 &&
-       plot -> dps_plot_stat_str.empty() &&
-       reforge_plot -> reforge_plot_stat_str.empty() &&
-       profileset_map.size() == 0 && ! profileset_enabled )
+  void run() override
+  { execute(); }
+
+public:
+  std::string error_str;
+
+  merge_task_t( sim_t& t, sim_t& s ) : target( t ), source( s )
+  { }
+
+  using sc_thread_t::launch;
+  using sc_thread_t::join;
+
+  void execute()
   {
-    std::cout << "Merging data from thread-" << other_sim.thread_index << " ..." << std::endl;
+    try
+    {
+      target.merge( source );
+    }
+    catch ( const std::exception& e )
+    {
+      error_str = fmt::format( "Error merging child simulation ({}): {}", source.thread_index, e.what() );
+    }
+    catch ( ... )
+    {
+      error_str = fmt::format( "Error merging child simulation ({}): unknown exception", source.thread_index );
+    }
   }
+};
+} // unnamed namespace
+
+/// merge the collected data of another sim into this one
+void sim_t::merge( sim_t& other_sim )
+{
+  auto_lock_t auto_lock( merge_mutex );
 
   iterations += other_sim.iterations;
-  work_per_thread[ other_sim.thread_index ] = other_sim.work_done;
 
   simulation_length.merge( other_sim.simulation_length );
   total_dmg.merge( other_sim.total_dmg );
@@ -2899,35 +3030,111 @@ void sim_t::merge( sim_t& other_sim )
   spawner::merge( *this, other_sim );
 
   range::append( iteration_data, other_sim.iteration_data );
-  merge_time += util::duration_fp_seconds( start );
   init_time += other_sim.init_time;
+  init_profile.merge( other_sim.init_profile );
+  cpu_profile.merge( other_sim.cpu_profile );
+}
+
+/// record the thread statistics of a ( joined ) sim
+void sim_t::merge_thread_statistics( const sim_t& other_sim )
+{
+  work_per_thread[ other_sim.thread_index ] = other_sim.work_done;
+  busy_time_per_thread[ other_sim.thread_index ] = other_sim.busy_time;
+  run_time_per_thread[ other_sim.thread_index ] = other_sim.run_time;
+  steals_per_thread[ other_sim.thread_index ] = other_sim.work_queue -> steals( other_sim.thread_index );
 }
 
-/// merge all sims together
-void sim_t::merge()
+/// merge all sims together, returns false if the data of a child could not be merged
+bool sim_t::merge()
 {
-  work_per_thread[ thread_index ] = work_done;
+  merge_thread_statistics( *this );
 
   if ( children.empty() )
-    return;
+    return true;
 
-  merge_mutex.unlock();
+  auto start = std::chrono::high_resolution_clock::now();
+  bool verbose = scaling -> scale_stat == STAT_NONE &&
+                 scaling -> calculate_scale_factors == 0 &&
+                 plot -> dps_plot_stat_str.empty() &&
+                 reforge_plot -> reforge_plot_stat_str.empty() &&
+                 profileset_map.size() == 0 && ! profileset_enabled;
 
-  for ( size_t i = 0; i < children.size(); i++ )
+  std::vector<sim_t*> sims { this };
+  for ( auto child : children )
   {
-    sim_t* child = children[ i ];
     if ( child )
     {
       child -> join();
-      children[ i ] = nullptr;
-      if ( requires_cleanup() )
+      merge_thread_statistics( *child );
+      if ( child -> initialized )
       {
-        delete child;
+        if ( verbose )
+        {
+          std::cout << "Merging data from thread-" << child -> thread_index << " ..." << std::endl;
+        }
+        sims.push_back( child );
       }
     }
   }
 
+  // Pairwise tree reduction over the sims in thread order: each round, sim i merges sim i + stride,
+  // with all merges of a round running in parallel. The shape of the reduction only depends on the
+  // number of sims, so the merged results do not depend on the order in which the threads finish,
+  // and the parent is done after log2( threads ) rounds instead of threads - 1 serial merges.
+  // Merge tasks run on pool threads, where errors are not recorded, so the errors of a round are
+  // collected and raised on this sim once all of its tasks are joined.
+  std::vector<std::string> merge_errors;
+  for ( size_t stride = 1; stride < sims.size() && merge_errors.empty(); stride *= 2 )
+  {
+    std::vector<std::unique_ptr<merge_task_t>> tasks;
+    for ( size_t i = 0; i + stride < sims.size(); i += 2 * stride )
+    {
+      tasks.push_back( std::make_unique<merge_task_t>( *sims[ i ], *sims[ i + stride ] ) );
+    }
+
+    for ( size_t i = 1; i < tasks.size(); ++i )
+    {
+      tasks[ i ] -> launch();
+    }
+    tasks.front() -> execute();
+
+    for ( size_t i = 0; i < tasks.size(); ++i )
+    {
+      if ( i > 0 )
+      {
+        tasks[ i ] -> join();
+      }
+
+      if ( ! tasks[ i ] -> error_str.empty() )
+      {
+        merge_errors.push_back( tasks[ i ] -> error_str );
+      }
+    }
+  }
+
+  // Partially merged results are not analyzed
+  for ( const auto& error_str : merge_errors )
+  {
+    error( "{}", error_str );
+  }
+  if ( ! merge_errors.empty() )
+  {
+    cancel();
+  }
+
+  for ( auto& child : children )
+  {
+    if ( child && requires_cleanup() )
+    {
+      delete child;
+    }
+    child = nullptr;
+  }
+
   children.clear();
+  merge_time += util::duration_fp_seconds( start );
+
+  return merge_errors.empty();
 }
 
 // sim_t::run ===============================================================
@@ -2936,10 +3143,8 @@ void sim_t::run()
 {
   try
   {
-    if( iterate() )
-    {
-      parent -> merge( *this );
-    }
+    // The parent merges the results once the thread is joined
+    iterate();
   }
   catch (const std::exception& e )
   {
@@ -2949,6 +3154,243 @@ void sim_t::run()
   }
 }
 
+// sim_t::work_queue_t =====================================================
+
+namespace
+{
+uint64_t pack_range( int begin, int end )
+{ return ( static_cast<uint64_t>( begin ) << 32 ) | static_cast<uint32_t>( end ); }
+
+int range_begin( uint64_t range )
+{ return static_cast<int>( range >> 32 ); }
+
+int range_end( uint64_t range )
+{ return static_cast<int>( range & 0xFFFFFFFF ); }
+} // unnamed namespace
+
+constexpr int sim_t::work_queue_t::MAX_CHUNK;
+
+sim_t::work_queue_t::work_queue_t() :
+  n_batches( 0 ), n_ranges( 0 ), _end( 0 ), next( 0 ), index( 0 )
+{
+  batches( 1 );
+  init_threads( 1 );
+}
+
+void sim_t::work_queue_t::batches( size_t n )
+{
+  _batches.reset( new batch_t[ n ] );
+  n_batches = n;
+  init( 0 );
+}
+
+void sim_t::work_queue_t::init_threads( size_t n )
+{
+  _ranges.reset( new range_t[ n ] );
+  n_ranges = n;
+  for ( size_t i = 0; i < n_ranges; ++i )
+  {
+    _ranges[ i ].steals = 0;
+  }
+  reset_ranges();
+}
+
+void sim_t::work_queue_t::init( int w )
+{
+  // Iterations are numbered across all batches, and claimed ranges pack them into 32 bits
+  int64_t end = as<int64_t>( n_batches ) * w;
+  if ( end > std::numeric_limits<int>::max() )
+  {
+    throw std::invalid_argument( fmt::format( "Too many iterations: {} batches of {} iterations exceed {} in total.",
+                                              n_batches, w, std::numeric_limits<int>::max() ) );
+  }
+
+  int start = 0;
+  for ( size_t i = 0; i < n_batches; ++i )
+  {
+    batch_t& b = _batches[ i ];
+    b.start = start;
+    b.total = w;
+    b.projected = w;
+    b.work = 0;
+    b.closed = false;
+    start += w;
+  }
+
+  _end = end;
+  // Iteration 0 is the first iteration of each thread
+  next = 1;
+  index = 0;
+  reset_ranges();
+}
+
+void sim_t::work_queue_t::reset_ranges()
+{
+  for ( size_t i = 0; i < n_ranges; ++i )
+  {
+    _ranges[ i ].range = pack_range( 0, 0 );
+  }
+}
+
+void sim_t::work_queue_t::flush( int idx )
+{
+  size_t first = idx < 0 ? 0 : as<size_t>( idx );
+  size_t last = idx < 0 ? n_batches : first + 1;
+  if ( last > n_batches )
+    return;
+
+  for ( size_t i = first; i < last; ++i )
+  {
+    batch_t& b = _batches[ i ];
+    b.closed = true;
+    b.total = b.projected = b.work.load();
+  }
+
+  // Skip the central counter past the closed batches. Iterations of closed batches already claimed
+  // by threads are discarded in pop().
+  int batch_end = last == n_batches ? as<int>( _end ) : _batches[ last ].start;
+  int n = next.load();
+  while ( n < batch_end && !next.compare_exchange_weak( n, batch_end ) )
+  {
+  }
+}
+
+void sim_t::work_queue_t::project( int w, int idx )
+{
+  size_t i = idx < 0 ? index.load() : as<size_t>( idx );
+  _batches[ std::min( i, n_batches - 1 ) ].projected = w;
+}
+
+size_t sim_t::work_queue_t::batch_of( int iteration ) const
+{
+  size_t lo = 0, hi = n_batches;
+  while ( hi - lo > 1 )
+  {
+    size_t mid = ( lo + hi ) / 2;
+    if ( _batches[ mid ].start <= iteration )
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+bool sim_t::work_queue_t::pop( size_t thread, int& iteration, size_t& batch )
+{
+  range_t& own = _ranges[ thread % n_ranges ];
+
+  while ( true )
+  {
+    uint64_t r = own.range.load();
+    int begin = range_begin( r );
+    if ( begin >= range_end( r ) )
+    {
+      if ( !refill( thread ) )
+        return false;
+
+      continue;
+    }
+
+    // Thieves shrink the range from the back, so the front may only fail to update on a steal
+    if ( !own.range.compare_exchange_weak( r, pack_range( begin + 1, range_end( r ) ) ) )
+      continue;
+
+    size_t b = batch_of( begin );
+    // Only count the iteration while the batch is open, a closed batch discards it
+    batch_t& data = _batches[ b ];
+    int work = data.work.load();
+    bool closed = data.closed.load();
+    while ( ! closed && ! data.work.compare_exchange_weak( work, work + 1 ) )
+    {
+      closed = data.closed.load();
+    }
+
+    if ( closed )
+      continue;
+
+    size_t current = index.load();
+    while ( current < b && !index.compare_exchange_weak( current, b ) )
+    {
+    }
+
+    iteration = begin;
+    batch = b;
+    return true;
+  }
+}
+
+bool sim_t::work_queue_t::refill( size_t thread )
+{
+  range_t& own = _ranges[ thread % n_ranges ];
+
+  // Claim a chunk from the central counter. Chunks shrink as the remaining work does, so all
+  // threads run out of claimed work at about the same time.
+  int n = next.load();
+  while ( n < _end )
+  {
+    int chunk = as<int>( clamp( ( _end - n ) / as<int64_t>( 4 * n_ranges ), int64_t( 1 ), int64_t( MAX_CHUNK ) ) );
+    if ( next.compare_exchange_weak( n, n + chunk ) )
+    {
+      own.range = pack_range( n, n + chunk );
+      return true;
+    }
+  }
+
+  // Steal the back half of the largest range claimed by another thread
+  while ( true )
+  {
+    range_t* victim = nullptr;
+    uint64_t victim_range = 0;
+    int largest = 0;
+    for ( size_t i = 0; i < n_ranges; ++i )
+    {
+      if ( &_ranges[ i ] == &own )
+        continue;
+
+      uint64_t r = _ranges[ i ].range.load();
+      int remaining = range_end( r ) - range_begin( r );
+      if ( remaining > largest )
+      {
+        largest = remaining;
+        victim = &_ranges[ i ];
+        victim_range = r;
+      }
+    }
+
+    if ( !victim )
+      return false;
+
+    int end = range_end( victim_range );
+    int take = largest - largest / 2;
+    if ( victim->range.compare_exchange_weak( victim_range,
+                                               pack_range( range_begin( victim_range ), end - take ) ) )
+    {
+      own.range = pack_range( end - take, end );
+      own.steals++;
+      return true;
+    }
+  }
+}
+
+double sim_t::work_queue_t::iteration_pct( int iteration ) const
+{
+  const batch_t& b = _batches[ batch_of( iteration ) ];
+  int total = b.total;
+  if ( total <= 0 )
+    return 1.0;
+
+  return std::min( 1.0, ( iteration - b.start ) / static_cast<double>( total ) );
+}
+
+sim_progress_t sim_t::work_queue_t::progress( int idx ) const
+{
+  size_t i = idx < 0 ? index.load() : as<size_t>( idx );
+  const batch_t& b = _batches[ std::min( i, n_batches - 1 ) ];
+
+  return sim_progress_t{ b.work, b.projected };
+}
+
 // sim_t::partition =========================================================
 
 void sim_t::partition()
@@ -2962,16 +3404,15 @@ void sim_t::partition()
 
   thread::set_main_thread_priority();
 
-  merge_mutex.lock(); // parent sim is locked until parent merge() is called
-
   int remainder = iterations % threads;
   iterations /= threads;
 
-  // Normally we use a shared work-queue to ensure proper load balancing among threads.
-  // However, when we desire deterministic runs (for debugging) we need to force the
-  // sims to each use a specific number of iterations as opposed to using shared pool of work.
+  // Normally we use a shared work-queue to ensure proper load balancing among threads. Deterministic
+  // runs share it too, as each iteration is seeded from its global index. A strict work queue
+  // forces the sims to each use a specific number of iterations as opposed to using shared pool of
+  // work.
 
-  if ( deterministic || strict_work_queue )
+  if ( strict_work_queue )
   {
     work_queue -> init( iterations );
   }
@@ -3005,7 +3446,7 @@ void sim_t::partition()
       remainder--;
     }
 
-    if( deterministic || strict_work_queue )
+    if( strict_work_queue )
     {
       child -> work_queue -> init( child -> iterations );
     }
@@ -3014,6 +3455,7 @@ void sim_t::partition()
       child -> work_queue = work_queue;
     }
     child -> report_progress = 0;
+    child -> iteration_data_file = iteration_data_file;
   }
 
   computer_process::set_priority( process_priority ); // Set main thread priority
@@ -3037,12 +3479,31 @@ bool sim_t::execute()
   double start_wall_time = util::wall_time();
 
   bool success = false;
+  bool merged = false;
   {
-    auto merge_final_action = gsl::finally([&](){ merge(); }); // Always merge, even in cases of unsuccessful simulation!
+    auto merge_final_action = gsl::finally([&](){ merged = merge(); }); // Always merge, even in cases of unsuccessful simulation!
+    // Only top-level sims export iteration data, profileset and scaling sims have a parent
+    if ( ! parent && ! iteration_data_file_str.empty() )
+    {
+      iteration_data_file = std::make_shared<report::iteration_data_file_t>( iteration_data_file_str );
+      if ( ! iteration_data_file -> is_open() )
+      {
+        errorf( "Unable to open iteration data file '%s'", iteration_data_file_str.c_str() );
+        iteration_data_file.reset();
+      }
+    }
     partition();
     success = iterate();
   }
 
+  // Children are deleted once merged, so this closes the iteration data file
+  if ( iteration_data_file && ! iteration_data_file -> error().empty() )
+  {
+    error( "{} '{}', the file is incomplete", iteration_data_file -> error(), iteration_data_file_str );
+  }
+  iteration_data_file.reset();
+  success = success && merged;
+
   if( success )
     analyze();
 
@@ -3333,6 +3794,12 @@ void sim_t::create_options()
   add_option( opt_int( "stat_cache", stat_cache ) );
   add_option( opt_int( "max_aoe_enemies", max_aoe_enemies ) );
   add_option( opt_bool( "optimize_expressions", optimize_expressions ) );
+  add_option( opt_bool( "compile_expressions", compile_expressions ) );
+  add_option( opt_bool( "dirty_reset", dirty_reset ) );
+  add_option( opt_bool( "dirty_reset_verify", dirty_reset_verify ) );
+  add_option( opt_bool( "init_profile", init_profile.enabled ) );
+  add_option( opt_int( "cpu_profile", cpu_profile.sample_rate, 0, std::numeric_limits<int>::max() ) );
+  add_option( opt_string( "cpu_profile_output", cpu_profile.output_file_str ) );
   add_option( opt_bool( "single_actor_batch", single_actor_batch ) );
   add_option( opt_bool( "progressbar_type", progressbar_type ) );
   add_option( opt_bool( "allow_experimental_specializations", allow_experimental_specializations ) );
@@ -3377,6 +3844,7 @@ void sim_t::create_options()
   add_option( opt_string( "html", html_file_str ) );
   add_option( opt_string( "json", json_file_str ) );
   add_option( opt_string( "json2", json_file_str ) );
+  add_option( opt_string( "iteration_data_file", iteration_data_file_str ) );
   add_option( opt_bool( "hosted_html", hosted_html ) );
   add_option( opt_int( "healing", healing ) );
   add_option( opt_bool( "log", log ) );
@@ -3384,6 +3852,7 @@ void sim_t::create_options()
   add_option( opt_bool( "save_raid_summary", save_raid_summary ) );
   add_option( opt_bool( "save_gear_comments", save_gear_comments ) );
   add_option( opt_bool( "buff_uptime_timeline", buff_uptime_timeline ) );
+  add_option( opt_float( "timeline_bin_size", timeline_bin_size, 1.0, 60.0 ) );
   add_option( opt_bool( "buff_stack_uptime_timeline", buff_stack_uptime_timeline ) );
   add_option( opt_bool( "json_full_states", json_full_states ) );
   // Bloodlust
@@ -3495,7 +3964,10 @@ void sim_t::create_options()
   add_option( opt_bool( "report_details", report_details ) );
   add_option( opt_bool( "report_raw_abilities", report_raw_abilities ) );
   add_option( opt_bool( "report_rng", report_rng ) );
+  add_option( opt_bool( "report_stat_cache", report_stat_cache ) );
+  add_option( opt_bool( "report_callbacks", report_callbacks ) );
   add_option( opt_int( "statistics_level", statistics_level ) );
+  add_option( opt_func( "sample_data_sketch", parse_sample_data_sketch ) );
   add_option( opt_bool( "separate_stats_by_actions", separate_stats_by_actions ) );
   add_option( opt_bool( "report_raid_summary", report_raid_summary ) ); // Force reporting of raid summary
   add_option( opt_string( "reforge_plot_output_file", reforge_plot_output_file_str ) );
@@ -3504,6 +3976,7 @@ void sim_t::create_options()
   add_option( opt_string( "apikey", apikey ) );
   add_option( opt_string( "apitoken", user_apitoken ) );
   add_option( opt_bool( "distance_targeting_enabled", distance_targeting_enabled ) );
+  add_option( opt_float( "distance_targeting_cell_size", spatial_index.cell_size, 1.0, 1000.0 ) );
   add_option( opt_bool( "ignore_invulnerable_targets", ignore_invulnerable_targets ) );
   add_option( opt_bool( "enable_dps_healing", enable_dps_healing ) );
   add_option( opt_float( "scaling_normalized", scaling_normalized ) );
@@ -3846,10 +4319,14 @@ void sim_t::setup( sim_control_t* c )
   {
     work_queue -> batches( player_no_pet_list.size() );
   }
+  work_queue -> init_threads( threads );
   work_queue -> init( iterations );
   if ( thread_index == 0 )
   {
     work_per_thread.resize( threads );
+    busy_time_per_thread.resize( threads );
+    run_time_per_thread.resize( threads );
+    steals_per_thread.resize( threads );
   }
 
   if( deterministic && ( target_error != 0 ) )
@@ -3872,7 +4349,7 @@ sim_progress_t sim_t::progress( std::string* detailed, int index )
   }
 
   // For work queues that are independent, collect all work done so far for the progressbar.
-  if ( deterministic || strict_work_queue )
+  if ( strict_work_queue )
   {
     AUTO_LOCK( relatives_mutex );
     for ( const auto& child : children )
@@ -3960,6 +4437,12 @@ void sim_t::abort()
 /// add chart to sim for end of report processing
 void sim_t::add_chart_data( const highchart::chart_t& chart )
 {
+  if ( auto collector = report::chart_data_collector_t::current() )
+  {
+    collector -> add( chart );
+    return;
+  }
+
   if ( chart.toggle_id_str_.empty() )
   {
     on_ready_chart_data.push_back( chart.to_aggregate_string( false ) );
@@ -3995,6 +4478,7 @@ void sim_t::print_spell_query()
  */
 std::vector<double> sc_timeline_t::build_divisor_timeline( const extended_sample_data_t& simulation_length, double bin_size )
 {
+  assert( !simulation_length.sketched() && "Timeline adjustment requires every fight length sample" );
   std::vector<double> divisor_timeline;
   // divisor_timeline is necessary because not all iterations go the same length of time
   size_t max_buckets = static_cast<size_t>( floor( simulation_length.max() / bin_size ) + 1);
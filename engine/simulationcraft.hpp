@@ -151,6 +151,8 @@ namespace highchart {
 // Cache Control ============================================================
 #include "util/cache.hpp"
 
+#include "sim/sc_init_profile.hpp"
+#include "sim/sc_cpu_profile.hpp"
 #include "sim/sc_profileset.hpp"
 
 #include "player/artifact_data.hpp"
@@ -919,13 +921,71 @@ struct event_manager_t
   uint64_t events_processed;
   uint64_t total_events_processed;
   uint64_t max_events_remaining;
-  unsigned timing_slice, global_event_id;
-  std::vector<event_t*> timing_wheel;
-  event_t* recycled_event_list;
-  int    wheel_seconds, wheel_size, wheel_mask, wheel_shift;
+  unsigned global_event_id;
+
+  /**
+   * One level of the hierarchical timing wheel. Each level holds 2^wheel_shift
+   * FIFO slots; slot i of level L contains the events whose time (in
+   * milliseconds) has digit i at position L, with all higher digits equal to the
+   * wheel cursor. Level 0 slots are exactly one millisecond wide, so events in a
+   * slot are ordered by insertion and never need a sorted insert. When the
+   * cursor enters a new slot of level L > 0, its events are cascaded down.
+   */
+  struct wheel_level_t
+  {
+    std::vector<event_t*> head, tail;
+    std::vector<uint64_t> occupied; // Bitmap of non-empty slots
+  };
+
+  /**
+   * Event memory is handed out from per-sim (and thus per-thread) slabs, split
+   * into power-of-two size classes from 64 to 4096 bytes. Each size class keeps
+   * its own free list of recycled blocks. Events larger than the largest size
+   * class are allocated individually. Every block starts with a header that
+   * records its size class, so the block is recycled correctly no matter how
+   * the event was created.
+   */
+  static constexpr unsigned MIN_EVENT_SIZE_SHIFT = 6;
+  static constexpr unsigned N_EVENT_SIZE_CLASSES = 7;
+  static constexpr std::size_t EVENT_SLAB_SIZE   = 16384;
+
+  struct event_block_header_t
+  {
+    unsigned size_class; // N_EVENT_SIZE_CLASSES for oversized events
+    unsigned size;       // Requested event size
+    unsigned index;      // Position of an oversized event in oversized_events
+  };
+
+  // Header space in front of each event, keeps the event itself suitably aligned
+  static constexpr std::size_t EVENT_HEADER_SIZE = 16;
+
+  struct event_size_class_t
+  {
+    event_t* free_list;
+    int current_slab;       // Slab blocks are currently carved from, or -1
+    unsigned live;          // Blocks in use by events
+    unsigned peak_live;     // Peak blocks in use by events
+    uint64_t n_allocations; // Events allocated, including reuse of recycled blocks
+    std::size_t bytes;      // Slab memory reserved for the size class
+  };
+
+  struct event_slab_t
+  {
+    char* data;
+    unsigned size_class;
+    unsigned n_blocks; // Blocks carved out of the slab so far
+  };
+
+  std::vector<wheel_level_t> timing_wheel;
+  uint64_t wheel_cursor; // Wheel position in milliseconds
+  std::array<event_size_class_t, N_EVENT_SIZE_CLASSES> event_size_classes;
+  std::vector<event_slab_t> event_slabs;
+  std::vector<event_t*> oversized_events; // Live events larger than the largest size class
+  unsigned oversized_peak_live;
+  uint64_t oversized_allocations;
+  int    wheel_seconds, wheel_levels, wheel_mask, wheel_shift;
   double wheel_granularity;
   timespan_t wheel_time;
-  std::vector<event_t*> allocated_events;
 
   stopwatch_t event_stopwatch;
   bool monitor_cpu;
@@ -941,9 +1001,27 @@ struct event_manager_t
  ~event_manager_t();
   void* allocate_event( std::size_t size );
   void recycle_event( event_t* );
+  std::size_t event_memory() const;
+
+  /// Size class index for an event of the given size, N_EVENT_SIZE_CLASSES if oversized
+  static unsigned event_size_class( std::size_t size )
+  {
+    unsigned index = 0;
+    while ( index < N_EVENT_SIZE_CLASSES && event_size_class_bytes( index ) < size + EVENT_HEADER_SIZE )
+      index++;
+    return index;
+  }
+
+  static std::size_t event_size_class_bytes( unsigned size_class )
+  { return std::size_t( 1 ) << ( MIN_EVENT_SIZE_SHIFT + size_class ); }
+
+  static event_block_header_t* event_block_header( event_t* e )
+  { return reinterpret_cast<event_block_header_t*>( reinterpret_cast<char*>( e ) - EVENT_HEADER_SIZE ); }
   void add_event( event_t*, timespan_t delta_time );
   void reschedule_event( event_t* );
   event_t* next_event();
+  unsigned wheel_insert( event_t* );
+  void wheel_advance();
   bool execute();
   void cancel();
   void flush();
@@ -952,6 +1030,39 @@ struct event_manager_t
   void merge( event_manager_t& other );
 };
 
+// Spatial Index ============================================================
+
+/**
+ * Uniform grid over actor positions for distance targeting. Actors are filed into square cells by
+ * their position, and moved between cells when the position changes (player_t::set_position). A
+ * query marks every actor in the cells overlapping the query circle, so callers only compute exact
+ * distances for marked actors and can drop the rest of a target list in a single pass.
+ */
+struct spatial_index_t
+{
+  struct entry_t
+  {
+    int64_t cell;
+    unsigned stamp;
+    bool indexed;
+  };
+
+  double cell_size;
+  double max_reach; // Largest combat reach of any indexed actor
+  unsigned stamp;
+  bool query_all;
+  std::vector<entry_t> entries; // Indexed by actor_index
+  std::unordered_map<int64_t, std::vector<player_t*>> cells;
+
+  spatial_index_t();
+  void update( player_t* actor );
+  void query( double x, double y, double radius );
+  /// Actors not marked by the last query are guaranteed to be further than its radius
+  bool candidate( const player_t* actor ) const;
+  int32_t cell_coordinate( double v ) const;
+  static int64_t cell_key( int32_t cx, int32_t cy );
+};
+
 // Simulation Engine ========================================================
 
 struct sim_t : private sc_thread_t
@@ -1019,7 +1130,9 @@ struct sim_t : private sc_thread_t
   double      travel_variance, default_skill;
   timespan_t  reaction_time, regen_periodicity;
   timespan_t  ignite_sampling_delta;
-  bool        fixed_time, optimize_expressions;
+  bool        fixed_time, optimize_expressions, compile_expressions;
+  // Reset only the buffs changed during an iteration, optionally checking the others against a full reset
+  bool        dirty_reset, dirty_reset_verify;
   int         current_slot;
   int         optimal_raid, log, debug_each;
   std::vector<uint64_t> debug_seed;
@@ -1261,6 +1374,7 @@ struct sim_t : private sc_thread_t
 
   // Auras and De-Buffs
   auto_dispose<std::vector<buff_t*>> buff_list;
+  std::vector<buff_t*> dirty_buffs; // sim buffs changed during the iteration, see dirty_reset
 
   // Global aura related delay
   timespan_t default_aura_delay;
@@ -1279,11 +1393,20 @@ struct sim_t : private sc_thread_t
   double elapsed_cpu;
   double elapsed_time;
   std::vector<size_t> work_per_thread;
+  std::vector<double> busy_time_per_thread, run_time_per_thread;
+  std::vector<unsigned> steals_per_thread;
   size_t work_done;
+  // Wall time spent simulating iterations, and in the iteration loop as a whole
+  double busy_time, run_time;
+  // Global index of the current iteration, as handed out by the work queue
+  int iteration_index;
+  uint64_t base_seed;
   double     iteration_dmg, priority_iteration_dmg,  iteration_heal, iteration_absorb;
   simple_sample_data_t raid_dps, total_dmg, raid_hps, total_heal, total_absorb, raid_aps;
   extended_sample_data_t simulation_length;
   double merge_time, init_time, analyze_time;
+  init_profile_t init_profile;
+  cpu_profile_t cpu_profile;
   // Deterministic simulation iteration data collectors for specific iteration
   // replayability
   std::vector<iteration_data_entry_t> iteration_data, low_iteration_data, high_iteration_data;
@@ -1307,8 +1430,13 @@ struct sim_t : private sc_thread_t
   std::vector<player_t*> targets_by_name;
   std::vector<std::string> id_dictionary;
   std::map<double, std::vector<double> > divisor_timeline_cache;
+  timeline_arena_t timeline_arena;
   std::string output_file_str, html_file_str, json_file_str;
   std::string reforge_plot_output_file_str;
+  // Binary per-iteration output, the file is shared by the sim threads of a top-level sim
+  std::string iteration_data_file_str;
+  std::shared_ptr<report::iteration_data_file_t> iteration_data_file;
+  std::unique_ptr<report::iteration_data_output_t> iteration_data_output;
   std::vector<std::string> error_list;
   int report_precision;
   int report_pets_separately;
@@ -1316,14 +1444,18 @@ struct sim_t : private sc_thread_t
   int report_details;
   int report_raw_abilities;
   int report_rng;
+  int report_stat_cache;
+  int report_callbacks;
   int hosted_html;
   int save_raid_summary;
   int save_gear_comments;
   int statistics_level;
+  double sample_data_sketch; // quantile sketch compression for sample data, 0 = keep every sample
   int separate_stats_by_actions;
   int report_raid_summary;
   int buff_uptime_timeline;
   int buff_stack_uptime_timeline;
+  double timeline_bin_size; // bin size of the sampled resource and stat timelines, in seconds
   int json_full_states;
   int decorated_tooltips;
 
@@ -1335,6 +1467,7 @@ struct sim_t : private sc_thread_t
   bool maximize_reporting;
   std::string apikey, user_apitoken;
   bool distance_targeting_enabled;
+  spatial_index_t spatial_index;
   bool ignore_invulnerable_targets;
   bool enable_dps_healing;
   double scaling_normalized;
@@ -1345,97 +1478,69 @@ struct sim_t : private sc_thread_t
   std::vector<sim_t*> children; // Manual delete!
   int thread_index;
   computer_process::priority_e process_priority;
+  /**
+   * Lock-free iteration scheduler. All iterations of the simulation are numbered globally, with
+   * single actor batches laid out one after another. Threads claim chunks of iterations from a
+   * central atomic counter into their own range, and once the counter is exhausted, steal the back
+   * half of the largest range left with another thread. Iteration 0 is the uncollected first
+   * iteration each thread runs, and is never handed out.
+   */
   struct work_queue_t
   {
-    private:
-#ifndef SC_NO_THREADING
-    std::recursive_mutex m;
-    using G = std::lock_guard<std::recursive_mutex>;
-#else
-    struct no_m {
-      void lock() {}
-      void unlock() {}
-    };
-    struct nop {
-      nop(no_m i) { (void)i; }
+    static constexpr int MAX_CHUNK = 256;
+
+    // Iterations [begin, end) claimed by a thread, packed into one word. Padded to a cache line so
+    // threads do not contend on each other's ranges.
+    struct range_t
+    {
+      std::atomic<uint64_t> range;
+      unsigned steals; // Written by the owning thread only
+      char pad[ 64 - sizeof( std::atomic<uint64_t> ) - sizeof( unsigned ) ];
     };
-    no_m m;
-    using G = nop;
-#endif
-    public:
-    std::vector<int> _total_work, _work, _projected_work;
-    size_t index;
 
-    work_queue_t() : index( 0 )
-    { _total_work.resize( 1 ); _work.resize( 1 ); _projected_work.resize( 1 ); }
+    struct batch_t
+    {
+      int start; // First iteration of the batch
+      std::atomic<int> total, projected, work;
+      std::atomic<bool> closed;
+    };
 
-    void init( int w )    { G l(m); range::fill( _total_work, w ); range::fill( _projected_work, w ); }
-    // Single actor batch sim init methods. Batches is the number of active actors
-    void batches( size_t n ) { G l(m); _total_work.resize( n ); _work.resize( n ); _projected_work.resize( n ); }
+    std::unique_ptr<batch_t[]> _batches;
+    std::unique_ptr<range_t[]> _ranges;
+    size_t n_batches, n_ranges;
+    int64_t _end; // One past the last iteration of the last batch
+    std::atomic<int> next; // Next iteration not yet claimed by a thread
+    std::atomic<size_t> index; // Latest batch iterations have been handed out from
 
-    void flush()          { G l(m); _total_work[ index ] = _projected_work[ index ] = _work[ index ]; }
-    int  size()           { G l(m); return index < _total_work.size() ? _total_work[ index ] : _total_work.back(); }
-    bool more_work()      { G l(m); return index < _total_work.size() && _work[ index ] < _total_work[ index ]; }
-    void lock()           { m.lock(); }
-    void unlock()         { m.unlock(); }
+    work_queue_t();
 
-    void project( int w )
-    {
-      G l(m);
-      _projected_work[ index ] = w;
-#ifdef NDEBUG
-      if ( w > _work[ index ] )
-      {
-      }
-#endif
-    }
-
-    // Single-actor batch pop, uses several indices of work (per active actor), each thread has it's
-    // own state on what index it is simulating
-    size_t pop()
-    {
-      G l(m);
+    void init( int w );
+    // Single actor batch sim init methods. Batches is the number of active actors
+    void batches( size_t n );
+    void init_threads( size_t n );
 
-      if ( _work[ index ] >= _total_work[ index ] )
-      {
-        if ( index < _work.size() - 1 )
-        {
-          ++index;
-        }
-        return index;
-      }
+    // Stop handing out iterations of batch idx, or of all batches if idx < 0
+    void flush( int idx = -1 );
+    int  size( size_t idx = 0 ) const
+    { return _batches[ std::min( idx, n_batches - 1 ) ].total; }
+    void project( int w, int idx = -1 );
+    unsigned steals( size_t thread ) const
+    { return _ranges[ thread % n_ranges ].steals; }
 
-      if ( ++_work[ index ] == _total_work[ index ] )
-      {
-        _projected_work[ index ] = _work[ index ];
-        if ( index < _work.size() - 1 )
-        {
-          ++index;
-        }
-        return index;
-      }
+    // Position of an iteration within its batch, as a fraction of the batch size
+    double iteration_pct( int iteration ) const;
 
-      return index;
-    }
+    // Claim the next iteration for a thread. Returns false when there is no more work.
+    bool pop( size_t thread, int& iteration, size_t& batch );
 
     // Standard progress method, normal mode sims use the single (first) index, single actor batch
-    // sims progress with the main thread's current index.
-    sim_progress_t progress( int idx = -1 )
-    {
-      G l(m);
-      size_t current_index = idx;
-      if ( idx < 0 )
-      {
-        current_index = index;
-      }
+    // sims progress with the given index, or the latest one iterations have been handed out from.
+    sim_progress_t progress( int idx = -1 ) const;
 
-      if ( current_index >= _total_work.size() )
-      {
-        return sim_progress_t{ _work.back(), _projected_work.back() };
-      }
-
-      return sim_progress_t{ _work[ current_index ], _projected_work[ current_index ] };
-    }
+  private:
+    bool refill( size_t thread );
+    size_t batch_of( int iteration ) const;
+    void reset_ranges();
   };
   std::shared_ptr<work_queue_t> work_queue;
 
@@ -1477,6 +1582,15 @@ struct sim_t : private sc_thread_t
   std::vector<std::string> profileset_output_data;
   bool profileset_enabled;
   int profileset_work_threads, profileset_init_threads;
+  // Racing mode: number of top profilesets to refine, iterations of the first round, and the growth
+  // of iterations per round
+  int profileset_racing, profileset_racing_iterations;
+  double profileset_racing_factor;
+  // On-disk result cache: directory (empty disables the cache), size limit in megabytes, and
+  // whether to re-simulate and overwrite cached results
+  std::string profileset_cache_dir;
+  int profileset_cache_size;
+  bool profileset_cache_refresh;
   profileset::profilesets_t profilesets;
 
 
@@ -1510,7 +1624,8 @@ struct sim_t : private sc_thread_t
   void      init();
   void      analyze();
   void      merge( sim_t& other_sim );
-  void      merge();
+  void      merge_thread_statistics( const sim_t& other_sim );
+  bool      merge();
   bool      iterate();
   void      partition();
   bool      execute();
@@ -2596,6 +2711,8 @@ public:
     if ( sim.report_details )
     {
       ratio.change_mode( !collect );
+      if ( sim.sample_data_sketch > 0 )
+        ratio.enable_sketch( sim.sample_data_sketch );
       ratio.reserve( std::min( as<unsigned>( sim.iterations ), 2048u ) );
     }
 
@@ -2660,6 +2777,8 @@ struct uptime_t : public uptime_common_t
     if ( sim.report_details )
     {
       uptime_sum.change_mode( !collect );
+      if ( sim.sample_data_sketch > 0 )
+        uptime_sum.enable_sketch( sim.sample_data_sketch );
       uptime_sum.reserve( std::min( as<unsigned>( sim.iterations ), 2048u ) );
     }
 
@@ -2671,6 +2790,8 @@ struct uptime_t : public uptime_common_t
     if ( sim.report_details )
     {
       uptime_instance.change_mode( !collect );
+      if ( sim.sample_data_sketch > 0 )
+        uptime_instance.enable_sketch( sim.sample_data_sketch );
       uptime_instance.reserve( std::min( as<unsigned>( sim.iterations ), 2048u ) );
     }
 
@@ -2759,6 +2880,8 @@ public:
     if ( sim.report_details )
     {
       interval_sum.change_mode( !collect );
+      if ( sim.sample_data_sketch > 0 )
+        interval_sum.enable_sketch( sim.sample_data_sketch );
       interval_sum.reserve( std::min( as<unsigned>( sim.iterations ), 2048u ) );
     }
 
@@ -3034,6 +3157,9 @@ struct cooldown_t
   double recharge_multiplier;
   timespan_t base_duration;
 
+  // Incremented on every state change, see expr_epoch_cache_t
+  uint64_t state_epoch;
+
   cooldown_t( const std::string& name, player_t& );
   cooldown_t( const std::string& name, sim_t& );
 
@@ -3118,7 +3244,10 @@ struct effect_callbacks_t
 
   proc_array_t procs;
 
-  effect_callbacks_t( sim_t* sim ) : sim( sim )
+  // Incremented whenever a callback is registered, invalidates action callback dispatch tables
+  unsigned generation;
+
+  effect_callbacks_t( sim_t* sim ) : sim( sim ), generation( 0 )
   { }
 
   bool has_callback( const std::function<bool(const T_CB*)> cmp ) const
@@ -3169,39 +3298,92 @@ private:
  * - Same goes for stat_buff_t, which works through player_t::stat_gain/loss
  * - Buffs with effects in a composite_ function need invalidates added to their buff_creator
  *
- * To create invalidation chains ( eg. Priest: Spirit invalidates Hit ) override the
- * virtual player_t::invalidate_cache( cache_e ) function.
- *
- * Attention: player_t::invalidate_cache( cache_e ) is recursive and may call itself again.
+ * Invalidation chains ( eg. Strength invalidates Attack Power ) form a dependency graph, built once
+ * in player_t::init_stat_cache(). Invalidating a cache clears it and all its transitive dependents
+ * in a single mask operation. To add chains that only depend on the actor setup ( spec, talents ),
+ * override player_t::init_stat_cache() and add them with player_stat_cache_t::add_dependency().
+ * Chains that depend on runtime state, or invalidations with side effects, go into an override of
+ * the virtual player_t::invalidate_cache( cache_e ) function.
  */
 struct player_stat_cache_t
 {
+  using mask_t = uint64_t;
+  static_assert( CACHE_MAX <= 64 && SCHOOL_MAX + 1 <= 64, "Stat cache masks are too narrow" );
+
   const player_t* player;
-  mutable std::array<bool, CACHE_MAX> valid;
-  mutable std::array < bool, SCHOOL_MAX + 1 > spell_power_valid, player_mult_valid, player_heal_mult_valid;
-  // 'valid'-states
+  // 'valid'-states, one bit per cache_e ( per school for the school dependent caches )
+  mutable mask_t valid;
+  mutable mask_t spell_power_valid, player_mult_valid, player_heal_mult_valid;
 private:
-  // cached values
-  mutable double _strength, _agility, _stamina, _intellect, _spirit;
-  mutable double _spell_power[SCHOOL_MAX + 1], _attack_power;
-  mutable double _attack_expertise;
-  mutable double _attack_hit, _spell_hit;
-  mutable double _attack_crit_chance, _spell_crit_chance;
-  mutable double _attack_haste, _spell_haste;
-  mutable double _attack_speed, _spell_speed;
-  mutable double _dodge, _parry, _block, _crit_block, _armor, _bonus_armor;
-  mutable double _mastery, _mastery_value, _crit_avoidance, _miss;
-  mutable double _player_mult[SCHOOL_MAX + 1], _player_heal_mult[SCHOOL_MAX + 1];
-  mutable double _damage_versatility, _heal_versatility, _mitigation_versatility;
-  mutable double _leech, _run_speed, _avoidance;
-  mutable double _rppm_haste_coeff, _rppm_crit_coeff;
-  mutable double _corruption, _corruption_resistance;
+  // cached values, indexed by cache_e ( or school )
+  mutable std::array<double, CACHE_MAX> _value;
+  mutable double _mastery_value;
+  mutable std::array<double, SCHOOL_MAX + 1> _spell_power, _player_mult, _player_heal_mult;
+  // caches cleared when a cache is invalidated, including itself
+  std::array<mask_t, CACHE_MAX> dependents;
+  bool dependents_finalized;
+
+  static mask_t bit( unsigned i )
+  { return mask_t( 1 ) << i; }
+
+  template <typename F>
+  double get( cache_e c, F&& f ) const
+  {
+    if ( !active )
+      return f();
+
+    if ( !( valid & bit( c ) ) )
+    {
+      if ( counting )
+        ++misses[ c ];
+      valid |= bit( c );
+      _value[ c ] = f();
+    }
+    else
+    {
+      if ( counting )
+        ++hits[ c ];
+      assert( _value[ c ] == f() );
+    }
+    return _value[ c ];
+  }
+
+  template <typename F>
+  double get_school( cache_e c, mask_t& school_valid, std::array<double, SCHOOL_MAX + 1>& values, school_e s,
+                     F&& f ) const
+  {
+    if ( !active )
+      return f();
+
+    if ( !( school_valid & bit( s ) ) )
+    {
+      if ( counting )
+        ++misses[ c ];
+      school_valid |= bit( s );
+      values[ s ] = f();
+    }
+    else
+    {
+      if ( counting )
+        ++hits[ c ];
+      assert( values[ s ] == f() );
+    }
+    return values[ s ];
+  }
 public:
   bool active; // runtime active-flag
+  bool counting; // maintain the counters below, only done for report_stat_cache
+  // Access and invalidation counters per cache_e, accumulated over all iterations
+  mutable std::array<uint64_t, CACHE_MAX> hits, misses;
+  std::array<uint64_t, CACHE_MAX> invalidations;
+
   void invalidate_all();
   void invalidate( cache_e );
+  void add_dependency( cache_e c, cache_e dependent );
+  void finalize_dependencies();
+  void merge( const player_stat_cache_t& other );
   double get_attribute( attribute_e ) const;
-  player_stat_cache_t( const player_t* p ) : player( p ), active( false ) { invalidate_all(); }
+  player_stat_cache_t( const player_t* p );
 #if defined(SC_USE_STAT_CACHE)
   // Cache stat functions
   double strength() const;
@@ -3398,23 +3580,76 @@ struct player_collected_data_t
   // used.
   int total_iterations;
 
-  struct action_sequence_data_t : noncopyable
+  // Decoded sample sequence entry. Entries are not stored in this form, action_sequence_t decodes
+  // them one at a time into a reused instance for the reports.
+  struct action_sequence_data_t
   {
     const action_t* action;
     const player_t* target;
-    const timespan_t time;
+    timespan_t time;
     timespan_t wait_time;
     std::vector< std::pair< buff_t*, std::vector<double> > > buff_list;
     std::vector< std::pair< cooldown_t*, std::vector<double> > > cooldown_list;
-    std::vector< std::pair<player_t*, std::vector< std::pair< buff_t*, std::vector<double> > > > > target_list;
+    std::vector< std::pair<const player_t*, std::vector< std::pair< buff_t*, std::vector<double> > > > > target_list;
     std::array<double, RESOURCE_MAX> resource_snapshot;
     std::array<double, RESOURCE_MAX> resource_max_snapshot;
 
-    action_sequence_data_t( const timespan_t& ts, const timespan_t& wait, const player_t* p );
-    action_sequence_data_t( const action_t* a, const player_t* t, const timespan_t& ts, const player_t* p );
+    action_sequence_data_t();
+  };
+
+  // Append-only packed recording of the sample sequence. Each entry stores the time delta to the
+  // previous entry as a varint, interned indices for actions, targets, buffs and cooldowns, and
+  // only the resources whose value changed since the previous entry.
+  class action_sequence_t
+  {
+    template <typename T>
+    struct intern_table_t
+    {
+      std::vector<T*> values;
+      std::unordered_map<const T*, unsigned> index;
+
+      unsigned get( T* value );
+    };
+
+    std::vector<uint8_t> data;
+    size_t n_entries;
+    // Offset of the fixed width duration of the last entry, if it is a wait
+    size_t last_wait_offset;
+    timespan_t last_time;
+    std::array<double, RESOURCE_MAX> last_resource;
+    std::array<double, RESOURCE_MAX> last_resource_max;
+
+    intern_table_t<const action_t> actions;
+    intern_table_t<const player_t> actors;
+    intern_table_t<buff_t> buffs;
+    intern_table_t<cooldown_t> cooldowns;
+
+    void add_entry( const action_t* a, const player_t* t, timespan_t ts, timespan_t wait, const player_t* p );
+    void put( uint64_t value );
+    void put_time( timespan_t value );
+    void put_double( double value );
+
+  public:
+    action_sequence_t();
+
+    void add( const action_t* a, const player_t* target, timespan_t ts, const player_t* p );
+    // Consecutive waits are merged into the previous wait entry
+    void add_wait( timespan_t ts, timespan_t wait, const player_t* p );
+    void reserve( size_t entries );
+    void clear();
+
+    size_t size() const
+    { return n_entries; }
+    bool empty() const
+    { return n_entries == 0; }
+    size_t memory_usage() const
+    { return data.size(); }
+
+    // Decode all entries in order, the entry passed to fn is only valid during the call
+    void for_each( const std::function<void( const action_sequence_data_t& )>& fn ) const;
   };
-  std::vector<action_sequence_data_t> action_sequence;
-  std::vector<action_sequence_data_t> action_sequence_precombat;
+  action_sequence_t action_sequence;
+  action_sequence_t action_sequence_precombat;
 
   // Buffed snapshot_stats (for reporting)
   struct buffed_stats_t
@@ -3963,6 +4198,7 @@ struct player_t : public actor_t
   double tmi_window;
 
   auto_dispose< std::vector<buff_t*> > buff_list;
+  std::vector<buff_t*> dirty_buffs; // buffs changed during the iteration, see sim_t::dirty_reset
   auto_dispose< std::vector<proc_t*> > proc_list;
   auto_dispose< std::vector<gain_t*> > gain_list;
   auto_dispose< std::vector<stats_t*> > stats_list;
@@ -4356,6 +4592,7 @@ public:
   double get_player_distance( const player_t& ) const;
   double get_ground_aoe_distance( const action_state_t& ) const;
   double get_position_distance( double m = 0, double v = 0 ) const;
+  void set_position( double x, double y );
   double compute_incoming_damage( timespan_t interval) const;
   double compute_incoming_magic_damage( timespan_t interval ) const;
   double calculate_time_to_bloodlust() const;
@@ -4459,6 +4696,7 @@ public:
   virtual void init_stats();
   virtual void init_distance_targeting();
   virtual void init_absorb_priority();
+  virtual void init_stat_cache();
   virtual void init_assessors();
   virtual void create_actions();
   virtual void init_actions();
@@ -5075,6 +5313,8 @@ public:
   // Variables used both during combat and for reporting
   simple_sample_data_t total_execute_time, total_tick_time;
   timespan_t iteration_total_execute_time, iteration_total_tick_time;
+  // Actual amount of the last completed iteration
+  double last_iteration_amount;
   double portion_amount;
   simple_sample_data_t total_intervals;
   timespan_t last_execute;
@@ -5248,6 +5488,19 @@ struct action_state_t : private noncopyable
 
 // Action ===================================================================
 
+/**
+ * The player callbacks an action can trigger, flattened into one contiguous list with a range for
+ * each proc type and proc type2. Callbacks that can never trigger from the action are left out,
+ * unless they disallow procs: those end the dispatch for proc actions, as in
+ * action_callback_t::trigger().
+ */
+struct action_callback_dispatch_t
+{
+  unsigned generation;
+  std::vector<action_callback_t*> callbacks;
+  std::array<unsigned, PROC1_TYPE_MAX * PROC2_TYPE_MAX + 1> offsets;
+};
+
 struct action_t : private noncopyable
 {
 public:
@@ -5678,6 +5931,15 @@ public:
   proc_t* starved_proc;
   uint_least64_t total_executions;
 
+  /**
+   * @brief Proc callback dispatch table of the action.
+   *
+   * Resolved on the first callback trigger in combat, and again if callbacks are registered
+   * afterwards. Counts the callbacks checked and triggered through it, for tuning.
+   */
+  std::unique_ptr<action_callback_dispatch_t> callback_dispatch;
+  uint_least64_t callbacks_checked, callbacks_fired;
+
   /**
    * @brief Cooldown for specific APL line.
    *
@@ -5907,7 +6169,7 @@ public:
 
   virtual bool execute_targeting( action_t* action ) const;
 
-  virtual std::vector<player_t*> targets_in_range_list( std::vector< player_t* >& tl ) const;
+  virtual std::vector<player_t*>& targets_in_range_list( std::vector< player_t* >& tl ) const;
 
   virtual std::vector<player_t*>& check_distance_targeting( std::vector< player_t* >& tl ) const;
 
@@ -6196,6 +6458,10 @@ public:
 
   virtual void init_finished();
 
+  void init_callback_dispatch();
+
+  void trigger_callbacks( proc_types pt, proc_types2 pt2, action_state_t* state );
+
   virtual void reset();
 
   virtual void cancel();
@@ -6923,6 +7189,9 @@ struct action_callback_t : private noncopyable
   }
   virtual ~action_callback_t() {}
   virtual void trigger( action_t*, void* call_data ) = 0;
+  // Static trigger conditions, callbacks that can never trigger from the action are left out of
+  // its callback dispatch table
+  virtual bool can_trigger( const action_t* ) const { return true; }
   virtual void reset() {}
   virtual void initialize() { }
   virtual void activate() { active = true; }
@@ -7038,6 +7307,10 @@ struct dbc_proc_callback_t : public action_callback_t
 
   virtual void initialize() override;
 
+  // Procs do not trigger from their own proc action
+  bool can_trigger( const action_t* a ) const override
+  { return ! proc_action || a -> internal_id != proc_action -> internal_id; }
+
   void trigger( action_t* a, void* call_data ) override
   {
     if ( cooldown && cooldown -> down() ) return;
@@ -8902,6 +9175,8 @@ void effect_callbacks_t<T_CB>::register_callback( unsigned proc_flags,
     sim -> out_debug.printf( "Registering callback proc_flags=%#.8x proc_flags2=%#.8x",
         proc_flags, proc_flags2 );
 
+  ++generation;
+
   // Default method for proccing is "on spell landing", if no "what type of
   // result procs this callback" is given
   if ( proc_flags2 == 0 )
@@ -8982,6 +9257,34 @@ void effect_callbacks_t<T_CB>::reset()
   T_CB::reset( all_callbacks );
 }
 
+// action_t::trigger_callbacks ==============================================
+
+// Trigger the player callbacks of the action for a proc type and proc type2, with the same rules
+// as action_callback_t::trigger()
+inline void action_t::trigger_callbacks( proc_types pt, proc_types2 pt2, action_state_t* state )
+{
+  if ( ! player -> in_combat ) return;
+
+  if ( ! callback_dispatch || callback_dispatch -> generation != player -> callbacks.generation )
+  {
+    init_callback_dispatch();
+  }
+
+  const auto& dispatch = *callback_dispatch;
+  auto index = pt * PROC2_TYPE_MAX + pt2;
+  for ( auto i = dispatch.offsets[ index ], end = dispatch.offsets[ index + 1 ]; i < end; ++i )
+  {
+    action_callback_t* cb = dispatch.callbacks[ i ];
+    if ( sim -> report_callbacks ) ++callbacks_checked;
+    if ( cb -> active )
+    {
+      if ( ! cb -> allow_procs && proc ) return;
+      if ( sim -> report_callbacks ) ++callbacks_fired;
+      cb -> trigger( this, state );
+    }
+  }
+}
+
 /**
  * Targetdata initializer for items. When targetdata is constructed (due to a call to
  * player_t::get_target_data failing to find an object for the given target), all targetdata
@@ -5,10 +5,14 @@
 
 #include "concurrency.hpp"
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #if defined( SC_WINDOWS )
 #define NOMINMAX
@@ -36,32 +40,154 @@ public:
   { return m.native_handle(); }
 };
 
-class sc_thread_t::native_t
+namespace {
+/**
+ * @brief Process-wide cache of worker threads.
+ *
+ * Launching an sc_thread_t hands the thread object to an idle pool thread, and only spawns a new
+ * system thread when every pooled thread is busy. Launched threads may block on the completion of
+ * threads they launch themselves (e.g., a profileset sim joining its children), so the pool never
+ * queues work behind a busy thread. Threads stay around after their work is done, so repeated sims
+ * (profilesets, scale factors, plots) reuse them instead of paying for thread creation and teardown
+ * for every child sim.
+ */
+class thread_pool_t
 {
-private:
-  std::unique_ptr<std::thread> t;
+  std::mutex m;
+  std::condition_variable cv;
+  std::deque<std::function<void()>> tasks;
+  std::vector<std::thread> threads;
+  size_t n_idle;
+  bool stopping;
 
-  static void execute( sc_thread_t* t )
+  void work()
   {
-    t -> run();
+    std::unique_lock<std::mutex> l( m );
+
+    while ( true )
+    {
+      ++n_idle;
+      cv.wait( l, [ this ]() { return stopping || ! tasks.empty(); } );
+      --n_idle;
+
+      // Queued work is finished before the pool shuts down
+      if ( tasks.empty() )
+      {
+        return;
+      }
+
+      auto task = std::move( tasks.front() );
+      tasks.pop_front();
+
+      l.unlock();
+      task();
+      l.lock();
+    }
   }
+
+public:
+  thread_pool_t() : n_idle( 0 ), stopping( false )
+  { }
+
+  // Destroyed at process exit. Pool threads finish their current and queued work, and are joined.
+  ~thread_pool_t()
+  {
+    std::vector<std::thread> joinable;
+    {
+      std::lock_guard<std::mutex> l( m );
+      stopping = true;
+      joinable.swap( threads );
+    }
+    cv.notify_all();
+
+    for ( auto& thread : joinable )
+    {
+      // A pool thread exiting the process cannot join itself
+      if ( thread.get_id() == std::this_thread::get_id() )
+      {
+        thread.detach();
+      }
+      else
+      {
+        thread.join();
+      }
+    }
+  }
+
+  void submit( std::function<void()> task )
+  {
+    std::lock_guard<std::mutex> l( m );
+
+    tasks.push_back( std::move( task ) );
+
+    // Every idle thread picks up exactly one task, so spawn a new thread only if queued work
+    // outnumbers the idle threads.
+    if ( tasks.size() > n_idle )
+    {
+      threads.emplace_back( &thread_pool_t::work, this );
+    }
+    else
+    {
+      cv.notify_one();
+    }
+  }
+
+  static thread_pool_t& instance()
+  {
+    static thread_pool_t pool;
+    return pool;
+  }
+};
+} // unnamed namespace
+
+class sc_thread_t::native_t
+{
+private:
+  mutable std::mutex m;
+  std::condition_variable cv;
+  bool running;
+  std::thread::id tid; // Pool thread running the thread object, only set while it runs
+
 public:
   native_t() :
-  t()
+  running( false ), tid()
   { }
 
   std::thread::id id() const
-  { return t -> get_id(); }
+  {
+    std::lock_guard<std::mutex> l( m );
+    return tid;
+  }
 
   void launch( sc_thread_t* thr)
   {
-    t = std::make_unique<std::thread>( &sc_thread_t::native_t::execute, thr );
+    {
+      std::lock_guard<std::mutex> l( m );
+      running = true;
+      tid = std::thread::id();
+    }
+
+    thread_pool_t::instance().submit( [ this, thr ]() {
+      {
+        std::lock_guard<std::mutex> l( m );
+        tid = std::this_thread::get_id();
+      }
+
+      thr -> run();
+
+      // Notify under the lock, as the joining thread may destroy this object as soon as it observes
+      // the finished state. The pool thread goes on to run other thread objects, so it no longer
+      // identifies this one.
+      std::lock_guard<std::mutex> l( m );
+      tid = std::thread::id();
+      running = false;
+      cv.notify_all();
+    } );
   }
 
   void join() {
-    if ( t && t -> joinable() ) {
-      t -> join();
-    }
+    std::unique_lock<std::mutex> l( m );
+    cv.wait( l, [ this ]() { return ! running; } );
   }
 
   static void sleep_seconds( double t )
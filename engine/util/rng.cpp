@@ -54,6 +54,33 @@ double convert_to_double_0_1( uint64_t ui64 )
   return u.d - 1.0;
 }
 
+/**
+ * Fill out with uniform [0, 1) values from consecutive outputs of a 64-bit engine. The raw
+ * outputs are generated first, so that the conversion loop has no dependency on the engine state
+ * and can be vectorized.
+ */
+template <typename Engine>
+void fill_uniform( Engine& engine, double* out, size_t n )
+{
+  uint64_t raw[ 64 ];
+  while ( n > 0 )
+  {
+    size_t count = std::min( n, sizeof( raw ) / sizeof( raw[ 0 ] ) );
+    for ( size_t i = 0; i < count; i++ )
+    {
+      raw[ i ] = engine.next();
+    }
+
+    for ( size_t i = 0; i < count; i++ )
+    {
+      out[ i ] = convert_to_double_0_1( raw[ i ] );
+    }
+
+    out += count;
+    n -= count;
+  }
+}
+
 
 /**
  * @brief STL Mersenne twister MT19937
@@ -72,14 +99,17 @@ struct rng_mt_cxx11_t : public rng_t
 
   const char* name() const override { return "mt_cxx11"; }
 
-  void seed( uint64_t start ) override
+  void engine_seed( uint64_t start ) override
   { 
     engine.seed( (unsigned) start ); 
   }
 
-  double real() override
-  { 
-    return dist( engine );
+  void fill( double* out, size_t n ) override
+  {
+    for ( size_t i = 0; i < n; i++ )
+    {
+      out[ i ] = dist( engine );
+    }
   }
 };
 
@@ -91,14 +121,19 @@ struct rng_mt_cxx11_64_t : public rng_t
 
   const char* name() const override { return "mt_cxx11_64"; }
 
-  void seed( uint64_t start ) override
+  void engine_seed( uint64_t start ) override
   {
     engine.seed( start );
   }
 
-  double real() override
+  uint64_t next()
+  {
+    return engine();
+  }
+
+  void fill( double* out, size_t n ) override
   {
-    return convert_to_double_0_1(engine());
+    fill_uniform( *this, out, n );
   }
 };
 
@@ -123,15 +158,15 @@ struct rng_murmurhash_t : public rng_t
 
   const char* name() const override { return "murmurhash3"; }
 
-  void seed( uint64_t start ) override
+  void engine_seed( uint64_t start ) override
   { 
     assert( start != 0 );
     x = start;
   }
 
-  double real() override
-  { 
-    return convert_to_double_0_1( next() );
+  void fill( double* out, size_t n ) override
+  {
+    fill_uniform( *this, out, n );
   }
 };
 
@@ -156,15 +191,15 @@ struct rng_xorshift64_t : public rng_t
 
   const char* name() const override { return "xorshift64"; }
 
-  void seed( uint64_t start ) override
+  void engine_seed( uint64_t start ) override
   { 
     assert( start != 0 );
     x = start;
   }
 
-  double real() override
-  { 
-    return convert_to_double_0_1( next() );
+  void fill( double* out, size_t n ) override
+  {
+    fill_uniform( *this, out, n );
   }
 };
 
@@ -190,7 +225,7 @@ struct rng_xorshift128_t : public rng_t
 
   const char* name() const override { return "xorshift128"; }
 
-  void seed( uint64_t start ) override
+  void engine_seed( uint64_t start ) override
   { 
     rng_murmurhash_t mmh;
     mmh.seed( start );
@@ -199,9 +234,9 @@ struct rng_xorshift128_t : public rng_t
     s[ 1 ] = mmh.next();
   }
 
-  double real() override
-  { 
-    return convert_to_double_0_1( next() );
+  void fill( double* out, size_t n ) override
+  {
+    fill_uniform( *this, out, n );
   }
 };
 
@@ -229,7 +264,7 @@ struct rng_xorshift1024_t : public rng_t
 
   const char* name() const override { return "xorshift1024"; }
 
-  void seed( uint64_t start ) override
+  void engine_seed( uint64_t start ) override
   { 
     rng_xorshift64_t xs64;
     xs64.seed( start );
@@ -237,9 +272,9 @@ struct rng_xorshift1024_t : public rng_t
     p = 0;
   }
 
-  double real() override
-  { 
-    return convert_to_double_0_1( next() );
+  void fill( double* out, size_t n ) override
+  {
+    fill_uniform( *this, out, n );
   }
 };
 
@@ -424,26 +459,6 @@ struct rng_sfmt_t : public rng_t
     return i;
   }
 
-  /**
-   * This function generates and returns unsigned 32-bit integer.
-   * This is slower than SFMT, only for convenience usage.
-   * dsfmt_init_gen_rand() or dsfmt_init_by_array() must be called
-   * before this function.
-   * @param dsfmt dsfmt internal state date
-   * @return double precision floating point pseudorandom number
-   */
-  uint32_t dsfmt_genrand_uint32(dsfmt_t *dsfmt) {
-      uint32_t r;
-      uint64_t *psfmt64 = &dsfmt->status[0].u[0];
-
-      if (dsfmt->idx >= DSFMT_N64) {
-          dsfmt_gen_rand_all(dsfmt);
-          dsfmt->idx = 0;
-      }
-      r = psfmt64[dsfmt->idx++] & 0xffffffffU;
-      return r;
-  }
-
   /**
    * This function initializes the internal state array with a 32-bit
    * integer seed.
@@ -469,16 +484,44 @@ struct rng_sfmt_t : public rng_t
     dsfmt->idx = DSFMT_N64;
   }
 
-  double dsfmt_genrand_close_open( dsfmt_t *dsfmt )
+  /**
+   * This function fills an array with double precision floating point
+   * pseudorandom numbers in the range [0, 1), continuing from the current
+   * position of the internal state array.
+   * @param dsfmt dsfmt state vector.
+   * @param out output array.
+   * @param n number of values to generate.
+   */
+  void dsfmt_fill_close_open( dsfmt_t *dsfmt, double* out, size_t n )
   {
-    double *psfmt64 = &dsfmt->status[0].d[0];
-
-    if ( dsfmt->idx >= DSFMT_N64 )
+    const double *psfmt64 = &dsfmt->status[0].d[0];
+    while ( n > 0 )
     {
-      dsfmt_gen_rand_all( dsfmt );
-      dsfmt->idx = 0;
+      if ( dsfmt->idx >= DSFMT_N64 )
+      {
+        dsfmt_gen_rand_all( dsfmt );
+        dsfmt->idx = 0;
+      }
+
+      size_t count = std::min( n, static_cast<size_t>( DSFMT_N64 - dsfmt->idx ) );
+      const double *src = psfmt64 + dsfmt->idx;
+      size_t i = 0;
+#ifdef RNG_USE_SSE2
+      const __m128d one = _mm_set1_pd( 1.0 );
+      for ( ; i + 2 <= count; i += 2 )
+      {
+        _mm_storeu_pd( out + i, _mm_sub_pd( _mm_loadu_pd( src + i ), one ) );
+      }
+#endif
+      for ( ; i < count; i++ )
+      {
+        out[ i ] = src[ i ] - 1.0;
+      }
+
+      dsfmt->idx += static_cast<int>( count );
+      out += count;
+      n -= count;
     }
-    return psfmt64[dsfmt->idx++];
   }
 
 #if defined(RNG_USE_SSE2)
@@ -503,22 +546,25 @@ struct rng_sfmt_t : public rng_t
 #endif
   }
   
-  void seed( uint64_t start ) override
+  void engine_seed( uint64_t start ) override
   { 
     dsfmt_chk_init_gen_rand( &dsfmt_global_data, (uint32_t) start ); 
   }
 
-  double real() override
-  { 
-    return dsfmt_genrand_close_open( &dsfmt_global_data ) - 1.0; 
+  void fill( double* out, size_t n ) override
+  {
+    dsfmt_fill_close_open( &dsfmt_global_data, out, n );
   }
 
   /**
-   * Special implementation because dsfmt only allows 32bit seed
+   * Special implementation because dsfmt only allows 32bit seed. The seed is taken from the low
+   * bits of the next raw output word, which the buffered [0, 1) value maps back to exactly.
    */
   uint64_t reseed() override
   {
-    uint64_t s = dsfmt_genrand_uint32( &dsfmt_global_data );
+    union { uint64_t ui64; double d; } w;
+    w.d = real() + 1.0;
+    uint64_t s = w.ui64 & 0xffffffffU;
     seed( s );
     reset();
     return s;
@@ -603,7 +649,7 @@ struct rng_tinymt_t : public rng_t
 
   const char* name() const override { return "tinymt"; }
 
-  void seed( uint64_t start ) override
+  void engine_seed( uint64_t start ) override
   {
     // mat1, mat2, and tmat are inputs to the engine
     // I am uncertain how to set them so we'll just grind the seed through MurmurHash.
@@ -616,10 +662,13 @@ struct rng_tinymt_t : public rng_t
     init( start );
   }
 
-  double real() override
+  void fill( double* out, size_t n ) override
   {
-    next_state();
-    return temper_conv_open() - 1.0;
+    for ( size_t i = 0; i < n; i++ )
+    {
+      next_state();
+      out[ i ] = temper_conv_open() - 1.0;
+    }
   }
 };
 
@@ -629,21 +678,6 @@ struct rng_tinymt_t : public rng_t
 // Probability Distributions
 // ==========================================================================
 
-/// Bernoulli Distribution
-bool rng_t::roll( double chance )
-{
-  if ( chance <= 0 ) return false;
-  if ( chance >= 1 ) return true;
-  return real() < chance;
-}
-
-/// Uniform distribution in the range [min max]
-double rng_t::range( double min, double max )
-{
-  assert( min <= max );
-  return min + real() * ( max - min );
-}
-
 /**
  * @brief Gaussian Distribution
  *
@@ -748,6 +782,13 @@ uint64_t rng_t::reseed()
   return w.s;
 }
 
+/// Generate the next block of uniform values
+void rng_t::refill()
+{
+  fill( buffer.data(), buffer.size() );
+  buffer_pos = 0;
+}
+
 /// reset any state
 void rng_t::reset()
 {
@@ -756,7 +797,7 @@ void rng_t::reset()
 }
 
 rng_t::rng_t() :
-    gauss_pair_value( 0.0 ), gauss_pair_use( false )
+    gauss_pair_value( 0.0 ), gauss_pair_use( false ), buffer(), buffer_pos( BUFFER_SIZE )
 {
 }
 
@@ -778,6 +819,21 @@ engine_type parse_type( const std::string& n )
   return engine_type::DEFAULT;
 }
 
+/**
+ * Derive the seed of stream n from a base seed by running the SplitMix64 output function on the
+ * n'th step of its sequence. Neighbouring streams get well mixed, uncorrelated seeds.
+ */
+uint64_t stream_seed( uint64_t seed, uint64_t stream )
+{
+  uint64_t z = seed + ( stream + 1 ) * 0x9E3779B97F4A7C15ULL;
+  z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+  z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+
+  // Some engines (xorshift) cannot be seeded with zero
+  return z != 0 ? z : 1;
+}
+
 /**
  * Factory method to create a rng object with given rng-engine type
  */
@@ -1088,6 +1144,58 @@ static void test_uniform_int( rng_t* rng, uint64_t n, unsigned num_buckets )
   fmt::print("time = {} ms\n\n", elapsed_cpu);
 }
 
+/**
+ * Roll-heavy proc paths: a real_ppm_t::trigger style chance computation followed by a roll, and
+ * a buff_t::trigger style roll against a fixed chance. The unbuffered variant draws every value
+ * with a virtual call into the engine, like rng_t::real() did before values were buffered.
+ */
+template <bool Buffered>
+static double draw( rng_t* rng )
+{
+  if ( Buffered )
+  {
+    return rng -> real();
+  }
+
+  double d;
+  rng -> fill( &d, 1 );
+  return d;
+}
+
+template <bool Buffered>
+static void test_proc_rolls( rng_t* rng, uint64_t n )
+{
+  int64_t start_time = milliseconds();
+
+  const double rppm = 2.0, haste_coeff = 1.3, attack_interval = 1.5;
+  double last_trigger = 0, last_success = 0, now = 0;
+  uint64_t rppm_procs = 0, buff_procs = 0;
+  for ( uint64_t i = 0; i < n; ++i )
+  {
+    now += attack_interval;
+
+    double real_ppm = rppm * haste_coeff;
+    double chance = real_ppm * ( std::min( now - last_trigger, 3.5 ) / 60.0 );
+    chance *= std::max( 1.0, 1 + ( ( std::min( now - last_success, 1000.0 ) / ( 60.0 / real_ppm ) - 1.5 ) * 3.0 ) );
+    last_trigger = now;
+    if ( draw<Buffered>( rng ) < chance )
+    {
+      last_success = now;
+      ++rppm_procs;
+    }
+
+    if ( draw<Buffered>( rng ) < 0.2 )
+    {
+      ++buff_procs;
+    }
+  }
+
+  int64_t elapsed_cpu = milliseconds() - start_time;
+
+  fmt::print( "{} proc rolls with {} ({}): rppm procs = {}, buff procs = {}, time = {} ms\n\n",
+      2 * n, rng -> name(), Buffered ? "buffered" : "unbuffered", rppm_procs, buff_procs, elapsed_cpu );
+}
+
 } // namespace rng
 
 int main( int /*argc*/, char** /*argv*/ )
@@ -1131,6 +1239,14 @@ int main( int /*argc*/, char** /*argv*/ )
   monte_carlo( rng_xs128,  n );
   monte_carlo( rng_xs1024, n );
 
+  for ( rng_t* r : { rng_sfmt, rng_xs128, rng_xs1024 } )
+  {
+    r -> seed( seed );
+    test_proc_rolls<false>( r, n );
+    r -> seed( seed );
+    test_proc_rolls<true>( r, n );
+  }
+
   test_seed( rng_mt_cxx11,   100000 );
   test_seed( rng_murmurhash,   100000 );
   test_seed( rng_sfmt,   100000 );
@@ -9,6 +9,8 @@
 /*! \defgroup SC_RNG Random Number Generator */
 
 #include "config.hpp"
+#include <array>
+#include <cassert>
 #include <memory>
 #include "sc_timespan.hpp"
 
@@ -31,19 +33,49 @@ enum class engine_type {
  */
 struct rng_t
 {
+  /// Number of uniform values generated at once into the buffer
+  static const size_t BUFFER_SIZE = 256;
 
   virtual ~rng_t() {}
   /// name of rng engine
   virtual const char* name() const = 0;
   /// seed rng engine
-  virtual void seed( uint64_t start ) = 0;
-  /// uniform distribution in range [0,1]
-  virtual double real() = 0;
+  void seed( uint64_t start )
+  {
+    engine_seed( start );
+    buffer_pos = BUFFER_SIZE;
+  }
+  /// uniform distribution in range [0,1), served from the buffer
+  double real()
+  {
+    if ( buffer_pos == BUFFER_SIZE )
+    {
+      refill();
+    }
+    return buffer[ buffer_pos++ ];
+  }
+  /**
+   * Generate n uniform values in range [0,1) directly from the engine. The values continue the
+   * engine sequence after the buffered ones, so this is only meant for benchmarking the engine.
+   */
+  virtual void fill( double* out, size_t n ) = 0;
   virtual uint64_t reseed();
   virtual void reset();
 
-  bool roll( double chance );
-  double range( double min, double max );
+  /// Bernoulli Distribution
+  bool roll( double chance )
+  {
+    if ( chance <= 0 ) return false;
+    if ( chance >= 1 ) return true;
+    return real() < chance;
+  }
+
+  /// Uniform distribution in the range [min max]
+  double range( double min, double max )
+  {
+    assert( min <= max );
+    return min + real() * ( max - min );
+  }
 
   template<class T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
   T range(T min, T max)
@@ -66,16 +98,25 @@ struct rng_t
   timespan_t exgauss( timespan_t mean, timespan_t stddev, timespan_t nu );
 protected:
   rng_t();
+  virtual void engine_seed( uint64_t start ) = 0;
 private:
+  void refill();
+
   // Allow re-use of unused ( but necessary ) random number of a previous call to gauss()  
   double gauss_pair_value; 
   bool   gauss_pair_use;
 
+  // Uniform values generated in bulk by the engine, consumed in order by real()
+  std::array<double, BUFFER_SIZE> buffer;
+  size_t buffer_pos;
 };
 
 std::unique_ptr<rng_t> create( engine_type = engine_type::DEFAULT );
 engine_type parse_type( const std::string& name );
 
+/// Non-zero seed of an independent stream derived from a base seed and a stream index
+uint64_t stream_seed( uint64_t seed, uint64_t stream );
+
 double stdnormal_cdf( double );
 double stdnormal_inv( double );
 
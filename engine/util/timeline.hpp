@@ -7,12 +7,15 @@
 #define TIMELINE_HPP
 
 #include <vector>
+#include <cmath>
 #include <cstring>
 #include <algorithm>
 #include <cassert>
 #include <numeric>
+#include <memory>
 
 #include "generic.hpp"
+#include "array_view.hpp"
 #include "sample_data.hpp"
 #include "sc_timespan.hpp"
 
@@ -75,39 +78,145 @@ inline Range& sliding_window_average( Range& r, unsigned window, Out out )
   return r;
 }
 
+// Contiguous storage for the timelines of a sim. Timelines claim all the bins of an expected fight
+// length at once, carved out of large blocks, instead of growing their own vectors while the sim
+// runs. Timelines outgrowing their bins fall back to heap storage.
+class timeline_arena_t : private noncopyable
+{
+  static const size_t BLOCK_BINS = 1 << 16;
+
+  std::vector<std::unique_ptr<double[]>> blocks;
+  size_t used;
+  double length;
+
+public:
+  timeline_arena_t() : used( BLOCK_BINS ), length( 0 ) {}
+
+  // Expected maximum length of a fight, in seconds
+  void set_length( double seconds )
+  { length = seconds; }
+
+  // Number of bins needed to cover the expected fight length
+  size_t bins( double bin_size ) const
+  { return length > 0 ? static_cast<size_t>( length / bin_size ) + 2 : 0; }
+
+  double* allocate( size_t n )
+  {
+    if ( n > BLOCK_BINS )
+    {
+      blocks.emplace_back( new double[ n ] );
+      return blocks.back().get();
+    }
+
+    if ( used + n > BLOCK_BINS )
+    {
+      blocks.emplace_back( new double[ BLOCK_BINS ] );
+      used = 0;
+    }
+
+    double* ptr = blocks.back().get() + used;
+    used += n;
+    return ptr;
+  }
+
+  size_t memory_usage() const
+  { return blocks.size() * BLOCK_BINS * sizeof( double ); }
+};
+
 // generic Timeline class
 class timeline_t
 {
 private:
-  std::vector<double> _data;
+  // Bins are either borrowed from a timeline_arena_t, or owned by _heap
+  double* _bins;
+  size_t _size, _capacity;
+  std::vector<double> _heap;
+
+  void move_to_heap( size_t capacity )
+  {
+    std::vector<double> heap( capacity );
+    std::copy( _bins, _bins + _size, heap.begin() );
+    _heap.swap( heap );
+    _bins = _heap.data();
+    _capacity = capacity;
+  }
+
+  void grow( size_t length )
+  {
+    if ( length > _capacity ) // we need to reallocate
+    {
+      // Reserve data less aggressively than doubling the size every time
+      move_to_heap( std::max( size_t( 10 ), static_cast<size_t>( length * 1.25 ) ) );
+    }
+    std::fill( _bins + _size, _bins + length, 0.0 );
+    _size = length;
+  }
 
 public:
-  timeline_t() : _data() {}
+  timeline_t() : _bins( nullptr ), _size( 0 ), _capacity( 0 ) {}
 
-  // const access to the underlying vector data
-  const std::vector<double>& data() const
-  { return _data; }
+  timeline_t( const timeline_t& other ) :
+    _bins( nullptr ), _size( 0 ), _capacity( 0 ), _heap( other._bins, other._bins + other._size )
+  {
+    _bins = _heap.data();
+    _size = _capacity = _heap.size();
+  }
+
+  timeline_t( timeline_t&& other ) :
+    _bins( other._bins ), _size( other._size ), _capacity( other._capacity ), _heap( std::move( other._heap ) )
+  {
+    other._bins = nullptr;
+    other._size = other._capacity = 0;
+  }
+
+  timeline_t& operator=( timeline_t other )
+  {
+    std::swap( _bins, other._bins );
+    std::swap( _size, other._size );
+    std::swap( _capacity, other._capacity );
+    _heap.swap( other._heap );
+    return *this;
+  }
+
+  // const access to the underlying data
+  arv::array_view<double> data() const
+  { return arv::array_view<double>( _bins, _size ); }
+
+  // Move the timeline to 'bins' bins of the arena, if it does not have that many yet
+  void attach( timeline_arena_t& arena, size_t bins )
+  {
+    if ( bins <= _capacity )
+      return;
+
+    double* storage = arena.allocate( bins );
+    std::copy( _bins, _bins + _size, storage );
+    _bins = storage;
+    _capacity = bins;
+    std::vector<double>().swap( _heap );
+  }
 
   void init( size_t length )
-  { _data.assign( length, 0.0 ); }
+  {
+    _size = 0;
+    grow( length );
+  }
 
   void resize( size_t length )
-  { _data.resize( length ); }
+  {
+    if ( length > _size )
+      grow( length );
+    else
+      _size = length;
+  }
 
   // Add 'value' at the specific index
   void add( size_t index, double value )
   {
-    if ( index >= _data.capacity() ) // we need to reallocate
-    {
-      // Reserve data less aggressively than doubling the size every time
-      _data.reserve( std::max( size_t( 10 ), static_cast<size_t>( index * 1.25 ) ) );
-      _data.resize( index + 1 );
-    }
-    else if ( index >= _data.size() ) // we still have enough capacity left, but need to resize up to index
+    if ( index >= _size )
     {
-      _data.resize( index + 1 );
+      grow( index + 1 );
     }
-    _data[ index ] += value;
+    _bins[ index ] += value;
   }
 
   // Adjust timeline by dividing through divisor timeline
@@ -115,9 +224,9 @@ public:
   void adjust( const std::vector<A>& divisor_timeline )
   {
 
-    for ( size_t j = 0, size = std::min( data().size(), divisor_timeline.size() ); j < size; j++ )
+    for ( size_t j = 0, size = std::min( _size, divisor_timeline.size() ); j < size; j++ )
     {
-      _data[ j ] /= divisor_timeline[ j ];
+      _bins[ j ] /= divisor_timeline[ j ];
     }
   }
 
@@ -140,19 +249,18 @@ public:
   // Merge with other timeline
   void merge( const timeline_t& other )
   {
-    // merge shared range
-    for ( size_t j = 0, num_buckets = std::min( _data.size(), other.data().size() ); j < num_buckets; ++j )
-      _data[ j ] += other.data()[ j ];
+    // if other is larger, extend to its length
+    if ( _size < other._size )
+      grow( other._size );
 
-    // if other is larger, insert tail
-    if ( _data.size() < other.data().size() )
-      _data.insert( _data.end(), other.data().begin() + _data.size(), other.data().end() );
+    for ( size_t j = 0, num_buckets = other._size; j < num_buckets; ++j )
+      _bins[ j ] += other._bins[ j ];
   }
 
   void build_sliding_average_timeline( timeline_t& out, unsigned window ) const
   {
-    out._data.reserve( data().size() );
-    sliding_window_average( data(), window, std::back_inserter( out._data ) );
+    out.init( _size );
+    sliding_window_average( data().begin(), data().end(), window, out._bins );
   }
 
   // Maximum value; 0 if no data available
@@ -164,7 +272,7 @@ public:
   { return data().empty() ? 0.0 : *std::min_element( data().begin(), data().end() ); }
 
   void clear()
-  { _data.clear(); }
+  { _size = 0; }
 
   std::ostream& data_str( std::ostream& s ) const
   {
@@ -250,11 +358,11 @@ public:
    */
   void create_histogram( const extended_sample_data_t& sd, size_t num_buckets, double min, double max )
   {
-    if ( sd.simple || sd.data().empty() )
+    if ( sd.simple || sd.count() == 0 )
       return;
     clear();
     _min = min; _max = max;
-    _data = statistics::create_histogram( sd.data(), num_buckets, _min, _max );
+    _data = sd.histogram( num_buckets, _min, _max );
     calculate_num_entries();
   }
 
@@ -262,8 +370,13 @@ public:
    */
   void create_histogram( const extended_sample_data_t& sd, size_t num_buckets )
   {
-    if ( sd.simple || sd.data().empty() )
+    if ( sd.simple || sd.count() == 0 )
+      return;
+    if ( sd.sketched() )
+    {
+      create_histogram( sd, num_buckets, sd.min(), sd.max() );
       return;
+    }
     double min = *std::min_element( sd.data().begin(), sd.data().end() );
     double max = *std::max_element( sd.data().begin(), sd.data().end() );
     create_histogram( sd, num_buckets, min, max );
@@ -362,27 +475,37 @@ struct sc_timeline_t : public timeline_t
   typedef timeline_t base_t;
   using timeline_t::add;
   double bin_size;
+  timespan_t bin_time; // Bin size in whole milliseconds, the resolution of the sim clock
 
-  sc_timeline_t() : timeline_t(), bin_size( 1.0 ) {}
+  sc_timeline_t() : timeline_t(), bin_size( 1.0 ), bin_time( bin_duration( 1.0 ) ) {}
 
   // methods to modify/retrieve the bin size
   void set_bin_size( double bin )
   {
     bin_size = bin;
+    bin_time = bin_duration( bin );
   }
   double get_bin_size() const
   {
     return bin_size;
   }
 
+  /// Duration of a (possibly fractional) bin size in seconds, events sampling a timeline once per
+  /// bin must use it so every sample lands in its own bin
+  static timespan_t bin_duration( double bin )
+  { return timespan_t::from_millis( std::max( 1.0, std::round( bin * 1000 ) ) ); }
+
+  size_t bin_index( timespan_t current_time ) const
+  { return static_cast<size_t>( current_time.total_millis() / bin_time.total_millis() ); }
+
   // Add 'value' at the corresponding time
   void add( timespan_t current_time, double value )
-  { base_t::add( static_cast<size_t>( current_time.total_millis() / 1000 / bin_size ), value ); }
+  { base_t::add( bin_index( current_time ), value ); }
 
   // Add 'value' at corresponding time, replacing existing entry if new value is larger
   void add_max( timespan_t current_time, double new_value )
   {
-    size_t index = static_cast<size_t>( current_time.total_millis() / 1000 / bin_size );
+    size_t index = bin_index( current_time );
     if ( data().size() == 0 || data().size() <= index )
       add( current_time, new_value );
     else if ( new_value > data().at( index ) )
@@ -391,6 +514,10 @@ struct sc_timeline_t : public timeline_t
     }
   }
 
+  // Claim the bins of the longest expected fight from the arena
+  void attach( timeline_arena_t& arena )
+  { base_t::attach( arena, arena.bins( bin_size ) ); }
+
   void adjust( sim_t& sim );
   void adjust( const extended_sample_data_t& adjustor );
 
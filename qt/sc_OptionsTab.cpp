@@ -937,7 +937,10 @@ void SC_OptionsTab::createToolTips()
 
   choice.deterministic_rng -> setToolTip( tr( "Deterministic Random Number Generator creates all random numbers with a given, constant seed.\n"
                                               "This allows to better observe marginal changes which aren't influenced by rng, \n"
-                                              " or check for other influences without having to reduce statistic noise" ) );
+                                              " or check for other influences without having to reduce statistic noise.\n"
+                                              "Each iteration is seeded from its index. In fixed time fights the per-iteration results and their\n"
+                                              "distributions (e.g. DPS mean, deviation and percentiles) do not depend on the number of threads,\n"
+                                              "while totals summed over iterations (e.g. raid DPS, timelines) can differ in the last digits." ) );
 
   choice.world_lag -> setToolTip( tr( "World Lag is the equivalent of the 'world lag' shown in the WoW Client.\n"
                                       "It is currently used to extend the cooldown duration of user executable abilities "
@@ -32,6 +32,8 @@
  HEADERS += engine/util/fmt/ranges.h
  HEADERS += engine/sim/x6_pantheon.hpp
  HEADERS += engine/sim/sc_profileset.hpp
+ HEADERS += engine/sim/sc_init_profile.hpp
+ HEADERS += engine/sim/sc_cpu_profile.hpp
  HEADERS += engine/sim/sc_option.hpp
  HEADERS += engine/sim/sc_expressions.hpp
  HEADERS += engine/report/sc_report.hpp
@@ -70,6 +72,8 @@
  SOURCES += engine/sim/sc_raid_event.cpp
  SOURCES += engine/sim/sc_progress_bar.cpp
  SOURCES += engine/sim/sc_profileset.cpp
+ SOURCES += engine/sim/sc_init_profile.cpp
+ SOURCES += engine/sim/sc_cpu_profile.cpp
  SOURCES += engine/sim/sc_plot.cpp
  SOURCES += engine/sim/sc_option.cpp
  SOURCES += engine/sim/sc_gear_stats.cpp
@@ -78,6 +82,7 @@
  SOURCES += engine/sim/sc_core_sim.cpp
  SOURCES += engine/sim/sc_cooldown.cpp
  SOURCES += engine/report/sc_report_text.cpp
+ SOURCES += engine/report/sc_report_iteration_data.cpp
  SOURCES += engine/report/sc_report_json.cpp
  SOURCES += engine/report/sc_report_html_sim.cpp
  SOURCES += engine/report/sc_report_html_player.cpp
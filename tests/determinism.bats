@@ -0,0 +1,29 @@
+load test_helper
+
+# Deterministic fixed time fights seed every iteration from its global index, so the stored
+# (per-iteration) sample data must not depend on the number of threads. Sum-only collectors such as
+# raid DPS and timelines are merged per thread and may differ in the last bits, and health based
+# fights carry the enemy health estimate across the iterations of a thread, so neither is covered.
+function dps_distribution() {
+  python3 -c '
+import json, sys
+sim = json.load( open( sys.argv[ 1 ] ) )[ "sim" ]
+print( repr( sorted( sim[ "statistics" ][ "simulation_length" ].items() ) ) )
+for player in sim[ "players" ]:
+  dps = player[ "collected_data" ][ "dps" ]
+  print( player[ "name" ], repr( sorted( dps.items() ) ) )
+' "$1"
+}
+
+@test "Deterministic fixed time DPS distribution does not depend on the thread count" {
+  sim deterministic=1 fixed_time=1 threads=1 json2=determinism_1.json
+  [ "${status}" -eq 0 ]
+  sim deterministic=1 fixed_time=1 threads=3 json2=determinism_3.json
+  [ "${status}" -eq 0 ]
+
+  cd "${SIMC_PROFILES_PATH}"
+  run diff <( dps_distribution determinism_1.json ) <( dps_distribution determinism_3.json )
+  rm -f determinism_1.json determinism_3.json
+  cd -
+  [ "${status}" -eq 0 ]
+}